@@ -0,0 +1,535 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Batch.hpp"
+
+#include "Solver.hpp"
+#include "Util.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#define PREFETCH(addr)
+#endif
+
+namespace Solver
+{
+
+namespace Batch
+{
+
+// Puzzles searched at the same time
+static const int NUM_LANE = 16;
+
+// Breadth First Search of one puzzle at a time, which is advanced one node at
+// a time.  Expanding a node is split in two, so that the table lookups of every
+// lane are started before any of them is needed.  The arrays are kept from one
+// puzzle to the next, so they are only allocated while the lane warms up.
+//
+// The nodes are kept as separate arrays of packed Squares, cell masks and
+// links.  The Squares and links are packed the same way as the nodes of
+// Solver::Solve, and the cell masks save unpacking a Square on every probe of
+// the table.
+class Lane
+{
+public:
+
+    Lane() = default;
+    Lane(const Lane& lane) = default;
+    Lane(Lane&& lane) noexcept = default;
+    ~Lane() = default;
+
+    Lane& operator=(const Lane& lane) = default;
+    Lane& operator=(Lane&& lane) noexcept = default;
+
+    bool IsDone() const;
+
+    void Start(const Board& board, const Square& square, int maxDepth, size_t memoryLimit);
+
+    // Move on to the next node to expand, and prefetch the table slots of
+    // its successors.  The search may be done afterwards.
+    void Prepare();
+    // Add the successors of the node found by Prepare
+    void Commit();
+
+    Solution& GetSolution();
+
+private:
+
+    static const int MAX_NODE = (1 << 30) - 1;
+
+    static const int CELL_BIT = 6;
+    static const uint32_t CELL_MASK = (1 << CELL_BIT) - 1;
+    static const uint32_t SOLVED_FLAG = 1 << (Square::NUM * CELL_BIT);
+    static const uint32_t REPEATED_FLAG = SOLVED_FLAG << 1;
+
+    static const int DIR_BIT = 2;
+    static const uint32_t DIR_MASK = (1 << DIR_BIT) - 1;
+
+    static const int MIN_SLOT_BIT = 10;
+    // Empty slots are 0, as each slot holds one more than the node index
+    static constexpr uint32_t EMPTY_SLOT = 0;
+
+    const Board* _board{ nullptr };
+    int _maxDepth{ 0 };
+    size_t _memoryLimit{ 0 };
+
+    std::vector<uint32_t> _state{ };
+    std::vector<uint64_t> _mask{ };
+    std::vector<uint32_t> _link{ };
+    int _slotBit{ MIN_SLOT_BIT };
+    std::vector<uint32_t> _slot{ };
+
+    int _nodeCount{ 0 };
+    // Index of the first node after the layer being searched
+    int _layerEnd{ 1 };
+    int _oldDepth{ 0 };
+    Solution::Status _solStatus{ Solution::Status::NONE };
+    int _solNode{ 0 };
+    int _solDepth{ 0 };
+    int _solNumPath{ 0 };
+
+    // Successors of the node found by Prepare
+    int _numNext{ 0 };
+    std::array<Movement::Dir, Movement::NUM_DIR> _nextDir{ };
+    std::array<uint32_t, Movement::NUM_DIR> _nextState{ };
+    std::array<uint64_t, Movement::NUM_DIR> _nextMask{ };
+
+    bool _done{ true };
+    Solution _solution{ };
+
+    [[nodiscard]] static uint32_t GetState(const Square& square);
+    [[nodiscard]] static Square GetSquare(uint32_t state);
+
+    size_t GetSlot(uint64_t mask) const;
+    int Find(uint64_t mask) const;
+    // Returns false if the node would exceed the memory limit
+    [[nodiscard]] bool Add(uint32_t state, uint64_t mask, uint32_t link);
+    void Grow();
+    void Finish();
+};
+
+static_assert(Board::NUM_TILES <= 64, "Lane cells must fit within 6 bits");
+
+bool Lane::IsDone() const
+{
+    return _done;
+}
+
+void Lane::Start(const Board& board, const Square& square, int maxDepth, size_t memoryLimit)
+{
+    // Precondition check
+    assert(_done);
+
+    _board = &board;
+    _maxDepth = maxDepth;
+    _memoryLimit = memoryLimit;
+
+    _state.clear();
+    _mask.clear();
+    _link.clear();
+    _slotBit = MIN_SLOT_BIT;
+    _slot.assign(static_cast<size_t>(1) << MIN_SLOT_BIT, EMPTY_SLOT);
+
+    _nodeCount = 0;
+    _layerEnd = 1;
+    _oldDepth = 0;
+    _solStatus = Solution::Status::NONE;
+    _solNode = 0;
+    _solDepth = 0;
+    _solNumPath = 0;
+    _numNext = 0;
+    _done = false;
+
+    if (!Add(GetState(square), square.GetMask(), 0)) {
+        _solStatus = Solution::Status::MEMORY_LIMIT_REACHED;
+        Finish();
+    }
+}
+
+void Lane::Prepare()
+{
+    // Precondition check
+    assert(!_done);
+
+    _numNext = 0;
+
+    while (true) {
+
+        if (_nodeCount == static_cast<int>(_state.size())) {
+            Finish();
+            return;
+        }
+
+        if (_nodeCount == _layerEnd) {
+            _layerEnd = static_cast<int>(_state.size());
+            _oldDepth++;
+        }
+
+        if (!(_state[_nodeCount] & SOLVED_FLAG))
+            break;
+
+        _nodeCount++;
+    }
+
+    int newDepth = _oldDepth + 1;
+
+    if (_solStatus == Solution::Status::SOLVED && newDepth > _solDepth) {
+        Finish();
+        return;
+    }
+
+    if (newDepth > _maxDepth) {
+        _solStatus = Solution::Status::MAX_DEPTH_REACHED;
+        Finish();
+        return;
+    }
+
+    Movement::ResultAll moveRes = Movement::MoveAll(*_board, GetSquare(_state[_nodeCount]));
+
+    for (Movement::Dir dir = Movement::Dir::UP;
+         dir <= Movement::Dir::RIGHT;
+         dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+        if (!moveRes.IsSuccess(dir))
+            continue;
+
+        const Square newSquare = moveRes.GetSquare(dir);
+
+        _nextDir[_numNext] = dir;
+        _nextState[_numNext] = GetState(newSquare);
+        _nextMask[_numNext] = newSquare.GetMask();
+
+        PREFETCH(&_slot[GetSlot(_nextMask[_numNext])]);
+
+        _numNext++;
+    }
+}
+
+// Same as a single expansion of the Breadth First Search in Solver::Solve
+void Lane::Commit()
+{
+    // Precondition check
+    assert(!_done);
+
+    int oldNumPath = (_state[_nodeCount] & REPEATED_FLAG) ? MAX_NUM_PATH : 1;
+    int newDepth = _oldDepth + 1;
+
+    for (int num = 0; num < _numNext; num++) {
+
+        uint32_t state = _nextState[num];
+        bool newSolved = state & SOLVED_FLAG;
+
+        int idx = Find(_nextMask[num]);
+
+        if (idx >= 0) {
+            // Paths through an earlier layer are not shortest paths
+            if (idx >= _layerEnd)
+                _state[idx] |= REPEATED_FLAG;
+        } else {
+            idx = static_cast<int>(_state.size());
+
+            if (oldNumPath >= MAX_NUM_PATH)
+                state |= REPEATED_FLAG;
+
+            uint32_t link = (static_cast<uint32_t>(_nodeCount + 1) << DIR_BIT) |
+                            static_cast<uint32_t>(static_cast<int>(_nextDir[num]) - 1);
+
+            if (!Add(state, _nextMask[num], link)) {
+                _solStatus = Solution::Status::MEMORY_LIMIT_REACHED;
+                Finish();
+                return;
+            }
+        }
+
+        if (newSolved) {
+
+            if (_solStatus == Solution::Status::NONE) {
+                _solStatus = Solution::Status::SOLVED;
+                _solNode = idx;
+                _solDepth = newDepth;
+            }
+
+            _solNumPath += oldNumPath;
+
+            if (_solNumPath >= MAX_NUM_PATH) {
+                _solStatus = Solution::Status::SHORTEST_SOLUTION_REPEATED;
+                Finish();
+                return;
+            }
+        }
+    }
+
+    _nodeCount++;
+}
+
+Solution& Lane::GetSolution()
+{
+    // Precondition check
+    assert(_done);
+
+    return _solution;
+}
+
+[[nodiscard]] uint32_t Lane::GetState(const Square& square)
+{
+    uint32_t retState = 0;
+
+    for (int num = 0; num < Square::NUM; num++) {
+        assert(square.GetCell(num) >= 0);
+        retState |= static_cast<uint32_t>(square.GetCell(num)) << (num * CELL_BIT);
+    }
+
+    if (square.IsSolved())
+        retState |= SOLVED_FLAG;
+
+    return retState;
+}
+
+[[nodiscard]] Square Lane::GetSquare(uint32_t state)
+{
+    Square::Cells cells;
+
+    for (int num = 0; num < Square::NUM; num++)
+        cells[num] = static_cast<int8_t>((state >> (num * CELL_BIT)) & CELL_MASK);
+
+    return Square(cells);
+}
+
+size_t Lane::GetSlot(uint64_t mask) const
+{
+    return static_cast<size_t>((mask * 0x9E3779B97F4A7C15) >> (64 - _slotBit));
+}
+
+int Lane::Find(uint64_t mask) const
+{
+    for (size_t slot = GetSlot(mask); ; slot = (slot + 1) & (_slot.size() - 1)) {
+
+        uint32_t idx = _slot[slot];
+        if (idx == EMPTY_SLOT)
+            return -1;
+
+        if (_mask[idx - 1] == mask)
+            return static_cast<int>(idx - 1);
+    }
+}
+
+[[nodiscard]] bool Lane::Add(uint32_t state, uint64_t mask, uint32_t link)
+{
+    size_t size = _state.size();
+
+    if (size == MAX_NODE)
+        return false;
+
+    // Keep the table at most half full
+    bool grow = 2 * (size + 1) > _slot.size();
+    size_t numSlot = grow ? 2 * _slot.size() : _slot.size();
+
+    if ((size + 1) * (sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t)) +
+        numSlot * sizeof(uint32_t) > _memoryLimit)
+        return false;
+
+    _state.emplace_back(state);
+    _mask.emplace_back(mask);
+    _link.emplace_back(link);
+
+    if (grow) {
+        Grow();
+    } else {
+        size_t slot = GetSlot(mask);
+        while (_slot[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & (_slot.size() - 1);
+        _slot[slot] = static_cast<uint32_t>(_state.size());
+    }
+
+    return true;
+}
+
+// Double the table and insert every node again
+void Lane::Grow()
+{
+    _slotBit++;
+    _slot.assign(static_cast<size_t>(1) << _slotBit, EMPTY_SLOT);
+
+    for (size_t idx = 0; idx < _state.size(); idx++) {
+        size_t slot = GetSlot(_mask[idx]);
+        while (_slot[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & (_slot.size() - 1);
+        _slot[slot] = static_cast<uint32_t>(idx + 1);
+    }
+}
+
+// Construct the Solution.  The nodes are kept until the next Start.
+void Lane::Finish()
+{
+    _done = true;
+
+    if (_solStatus != Solution::Status::SOLVED) {
+        if (_solStatus == Solution::Status::NONE)
+            _solution = Solution(Solution::Status::UNSOLVABLE);
+        else
+            _solution = Solution(_solStatus);
+    } else {
+
+        std::vector<Movement::Dir> retDir;
+        retDir.reserve(_solDepth + 1);
+
+        std::vector<Square> retSquare;
+        retSquare.reserve(_solDepth + 1);
+
+        int prevNode = _solNode;
+
+        do {
+            // Invariant check
+            assert(!(_state[prevNode] & REPEATED_FLAG));
+
+            int prev = static_cast<int>(_link[prevNode] >> DIR_BIT) - 1;
+
+            retDir.emplace_back(prev == -1 ? Movement::Dir::NONE :
+                                static_cast<Movement::Dir>((_link[prevNode] & DIR_MASK) + 1));
+            retSquare.emplace_back(GetSquare(_state[prevNode]));
+
+            prevNode = prev;
+
+        } while (prevNode != -1);
+
+        std::reverse(retDir.begin(), retDir.end());
+        std::reverse(retSquare.begin(), retSquare.end());
+
+        _solution = Solution(_solStatus, std::move(retDir), std::move(retSquare), _solDepth);
+    }
+}
+
+Workspace::Workspace() = default;
+Workspace::Workspace(Workspace&& workspace) noexcept = default;
+
+Workspace::~Workspace() = default;
+
+Workspace& Workspace::operator=(Workspace&& workspace) noexcept = default;
+
+std::vector<Lane>& Workspace::GetLane()
+{
+    return _lane;
+}
+
+// Every round expands one node of each lane which is not done yet.  All the
+// successors are generated before any of them is added, so the table lookups
+// of one lane are in flight while the others are worked on.  A lane which is
+// done moves on to the next puzzle.
+[[nodiscard]] static std::vector<Solution> SolveLanes(const std::vector<const Board*>& board,
+                                                      const std::vector<Square>& square,
+                                                      int maxDepth, size_t memoryLimit,
+                                                      std::vector<Lane>& lane)
+{
+    int numPuzzle = static_cast<int>(square.size());
+    int numLane = std::min(numPuzzle, NUM_LANE);
+
+    if (static_cast<int>(lane.size()) < numLane)
+        lane.resize(numLane);
+
+    std::vector<Solution> retSol(numPuzzle);
+    // Puzzle searched by each lane, or -1 if there is none
+    std::array<int, NUM_LANE> puzzle;
+    puzzle.fill(-1);
+
+    int nextPuzzle = 0;
+    int numDone = 0;
+
+    while (numDone < numPuzzle) {
+
+        for (int l = 0; l < numLane; l++) {
+            if (puzzle[l] == -1 && nextPuzzle < numPuzzle) {
+                lane[l].Start(*board.at(nextPuzzle), square.at(nextPuzzle), maxDepth, memoryLimit);
+                puzzle[l] = nextPuzzle++;
+            }
+        }
+
+        for (int l = 0; l < numLane; l++) {
+            if (!lane[l].IsDone())
+                lane[l].Prepare();
+        }
+
+        for (int l = 0; l < numLane; l++) {
+            if (!lane[l].IsDone())
+                lane[l].Commit();
+        }
+
+        for (int l = 0; l < numLane; l++) {
+            if (puzzle[l] >= 0 && lane[l].IsDone()) {
+                retSol.at(puzzle[l]) = std::move(lane[l].GetSolution());
+                puzzle[l] = -1;
+                numDone++;
+            }
+        }
+    }
+
+    return retSol;
+}
+
+[[nodiscard]] std::vector<Solution> Solve(const std::vector<Board>& board,
+                                          const std::vector<Square>& square, int maxDepth,
+                                          size_t memoryLimit)
+{
+    // Precondition check
+    assert(board.size() == square.size());
+    assert(maxDepth > 0);
+
+    std::vector<const Board*> brd;
+    brd.reserve(board.size());
+
+    for (size_t num = 0; num < square.size(); num++) {
+
+        // Precondition check
+        assert(Util::IsBoardSquareSane(board.at(num), square.at(num)));
+        assert(!square.at(num).IsSolved());
+
+        brd.emplace_back(&board.at(num));
+    }
+
+    std::vector<Lane> lane;
+    return SolveLanes(brd, square, maxDepth, memoryLimit, lane);
+}
+
+[[nodiscard]] std::vector<Solution> Solve(const Board& board,
+                                          const std::vector<Square>& square, int maxDepth,
+                                          size_t memoryLimit)
+{
+    Workspace workspace;
+    return Solve(board, square, maxDepth, workspace, memoryLimit);
+}
+
+[[nodiscard]] std::vector<Solution> Solve(const Board& board,
+                                          const std::vector<Square>& square, int maxDepth,
+                                          Workspace& workspace, size_t memoryLimit)
+{
+    // Precondition check
+    assert(maxDepth > 0);
+
+    for (const Square& sqr : square) {
+
+        // Precondition check
+        assert(Util::IsBoardSquareSane(board, sqr));
+        assert(!sqr.IsSolved());
+        (void)sqr;
+    }
+
+    return SolveLanes(std::vector<const Board*>(square.size(), &board), square,
+                      maxDepth, memoryLimit, workspace.GetLane());
+}
+
+} // namespace Batch
+
+} // namespace Solver
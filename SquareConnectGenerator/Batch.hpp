@@ -0,0 +1,70 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "Solver.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace Solver
+{
+
+namespace Batch
+{
+
+class Lane;
+
+// Lanes kept from one batch to the next, so that the arrays of a lane are only
+// allocated while it warms up
+class Workspace
+{
+public:
+
+    Workspace();
+    Workspace(const Workspace& workspace) = delete;
+    Workspace(Workspace&& workspace) noexcept;
+
+    ~Workspace();
+
+    Workspace& operator=(const Workspace& workspace) = delete;
+    Workspace& operator=(Workspace&& workspace) noexcept;
+
+    std::vector<Lane>& GetLane();
+
+private:
+
+    std::vector<Lane> _lane;
+};
+
+// Solve many puzzles with the Breadth First Search of Solver::Solve, one
+// Solution per puzzle in the same order.  The searches are advanced together,
+// which gives more throughput than solving the puzzles one at a time.  The
+// memory limit applies to each puzzle, and the Solutions are not cached.
+[[nodiscard]] std::vector<Solution> Solve(const std::vector<Board>& board,
+                                          const std::vector<Square>& square, int maxDepth,
+                                          size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+// Same as above, with every Square on the same Board
+[[nodiscard]] std::vector<Solution> Solve(const Board& board,
+                                          const std::vector<Square>& square, int maxDepth,
+                                          size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+// Same as above, with the lanes taken from a Workspace
+[[nodiscard]] std::vector<Solution> Solve(const Board& board,
+                                          const std::vector<Square>& square, int maxDepth,
+                                          Workspace& workspace,
+                                          size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+} // namespace Batch
+
+} // namespace Solver
+
+#endif // BATCH_HPP
@@ -0,0 +1,342 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Bidirectional.hpp"
+
+#include "Solver.hpp"
+#include "Util.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Solver
+{
+
+namespace Bidirectional
+{
+
+// Square found by the forward search
+struct Node
+{
+    Movement::Dir _dir{ Movement::Dir::NONE };
+    Square _square{ };
+    int _prevNode{ -1 };
+    int _numPath{ 1 };
+};
+
+// Square on a shortest solution beyond the layer where both searches meet
+struct Link
+{
+    Movement::Dir _dir{ Movement::Dir::NONE };
+    Square _square{ };
+    int _prevLink{ -1 };
+    int _numPath{ 1 };
+};
+
+[[nodiscard]] static std::vector<uint64_t> GetSolvedMasks(const Board& board)
+{
+    std::vector<uint64_t> retMask;
+    retMask.reserve((Board::NUM_ROW - 1) * (Board::NUM_COL - 1));
+
+    uint64_t walls = board.GetWallMask();
+    uint64_t block = static_cast<uint64_t>(0x3) |
+                     (static_cast<uint64_t>(0x3) << Board::NUM_COL);
+
+    for (int row = 0; row < Board::NUM_ROW - 1; row++) {
+        for (int col = 0; col < Board::NUM_COL - 1; col++) {
+
+            uint64_t mask = block << Board::GetCell(Pos(row, col));
+            if (!(mask & walls))
+                retMask.emplace_back(mask);
+        }
+    }
+
+    return retMask;
+}
+
+// Expand the last forward layer into a new one, in the same order as
+// Solver::Solve.  Returns whether a new Square was found by the backward
+// search, if there is one.
+static bool ExpandForward(const Board& board, std::vector<Node>& nodes, std::vector<int>& layer,
+                          std::unordered_map<uint64_t, int>& fwdNode,
+                          const std::unordered_map<uint64_t, int>* bwdDepth)
+{
+    int begin = layer.back();
+    int end = static_cast<int>(nodes.size());
+    bool met = false;
+
+    layer.emplace_back(end);
+
+    for (int idx = begin; idx < end; idx++) {
+
+        Movement::ResultAll moveRes = Movement::MoveAll(board, nodes.at(idx)._square);
+
+        for (Movement::Dir dir = Movement::Dir::UP;
+             dir <= Movement::Dir::RIGHT;
+             dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+            if (!moveRes.IsSuccess(dir))
+                continue;
+
+            const Square newSquare = moveRes.GetSquare(dir);
+            uint64_t mask = newSquare.GetMask();
+            auto [iter, inserted] = fwdNode.try_emplace(mask, static_cast<int>(nodes.size()));
+            if (!inserted) {
+                // Paths through an earlier layer are not shortest paths
+                if (iter->second >= end) {
+                    Node& node = nodes.at(iter->second);
+                    node._numPath = std::min(node._numPath + nodes.at(idx)._numPath,
+                                             MAX_NUM_PATH);
+                }
+                continue;
+            }
+
+            nodes.emplace_back(Node{ dir, newSquare, idx, nodes.at(idx)._numPath });
+
+            if (bwdDepth != nullptr && bwdDepth->contains(mask))
+                met = true;
+        }
+    }
+
+    return met;
+}
+
+// Status of a puzzle with no solution within the maximum depth.  Solver::Solve
+// only reports MAX_DEPTH_REACHED if a Square is still found at the maximum
+// depth, so the forward search goes on alone until it finds one or runs out.
+[[nodiscard]] static Solution GetUnsolvedStatus(const Board& board, std::vector<Node>& nodes,
+                                                std::vector<int>& layer,
+                                                std::unordered_map<uint64_t, int>& fwdNode,
+                                                int fwdLayerDepth, int maxDepth)
+{
+    while (fwdLayerDepth < maxDepth && layer.back() < static_cast<int>(nodes.size())) {
+        (void)ExpandForward(board, nodes, layer, fwdNode, nullptr);
+        fwdLayerDepth++;
+    }
+
+    if (layer.back() < static_cast<int>(nodes.size()))
+        return Solution(Solution::Status::MAX_DEPTH_REACHED);
+
+    return Solution(Solution::Status::UNSOLVABLE);
+}
+
+// The forward search is a layer by layer Breadth First Search from the Square,
+// identical to Solver::Solve.  The backward search is a Breadth First Search
+// over cell masks from every solved Square using reverse moves.  The smaller
+// frontier is expanded each time, until a layer of one search contains a
+// Square already found by the other.  At that point the shortest solution
+// depth is known, and every Square with the meeting forward depth and
+// backward depth lies on a shortest solution.
+//
+// Solver::Solve deems the puzzle solvable if there is only a single shortest
+// path to a solved Square.  To count the paths the same way, the meeting
+// Squares are searched forward once more, only keeping Squares whose backward
+// depth drops by one each move, and carrying the path counts of the forward
+// search along.  The order of the Squares, as well as the first move which
+// reaches each of them, is the same as in Solver::Solve, so the same Solution
+// is returned.  A puzzle without a solution within the maximum depth is
+// given the status Solver::Solve gives it by GetUnsolvedStatus.
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth)
+{
+    // Precondition check
+    assert(Util::IsBoardSquareSane(board, square));
+    assert(!square.IsSolved());
+    assert(maxDepth > 0);
+
+    std::vector<Node> nodes;
+    // Index of the first node of each forward layer
+    std::vector<int> layer{ 0 };
+    std::unordered_map<uint64_t, int> fwdNode;
+
+    std::unordered_map<uint64_t, int> bwdDepth;
+    std::vector<uint64_t> bwdFrontier = GetSolvedMasks(board);
+    std::vector<uint64_t> prevMask;
+
+    for (uint64_t mask : bwdFrontier)
+        bwdDepth.emplace(mask, 0);
+
+    nodes.emplace_back(Node{ Movement::Dir::NONE, square, -1 });
+    fwdNode.emplace(square.GetMask(), 0);
+
+    int fwdLayerDepth = 0;
+    int bwdLayerDepth = 0;
+    bool met = false;
+
+    while (!met) {
+
+        int fwdFrontierSize = static_cast<int>(nodes.size()) - layer.back();
+
+        if (fwdFrontierSize == 0)
+            return Solution(Solution::Status::UNSOLVABLE);
+
+        // There is no solution within the maximum depth once the backward
+        // search runs out, or once both searches together reach it
+        if (bwdFrontier.empty() || fwdLayerDepth + bwdLayerDepth + 1 > maxDepth)
+            return GetUnsolvedStatus(board, nodes, layer, fwdNode, fwdLayerDepth, maxDepth);
+
+        if (fwdFrontierSize <= static_cast<int>(bwdFrontier.size())) {
+
+            met = ExpandForward(board, nodes, layer, fwdNode, &bwdDepth);
+            fwdLayerDepth++;
+
+        } else {
+
+            std::vector<uint64_t> next;
+            bwdLayerDepth++;
+
+            for (uint64_t mask : bwdFrontier) {
+                for (Movement::Dir dir = Movement::Dir::UP;
+                     dir <= Movement::Dir::RIGHT;
+                     dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+                    prevMask.clear();
+                    Movement::MoveReverse(board, mask, dir, prevMask);
+
+                    for (uint64_t prev : prevMask) {
+
+                        if (!bwdDepth.try_emplace(prev, bwdLayerDepth).second)
+                            continue;
+
+                        next.emplace_back(prev);
+
+                        if (fwdNode.contains(prev))
+                            met = true;
+                    }
+                }
+            }
+
+            bwdFrontier = std::move(next);
+        }
+    }
+
+    int solDepth = fwdLayerDepth + bwdLayerDepth;
+
+    // Collect the meeting Squares in forward search order.  If the forward
+    // search met the solved Squares directly, start from its previous layer.
+
+    std::vector<std::vector<Link>> tail(1);
+
+    if (bwdLayerDepth > 0) {
+        for (int idx = layer.back(); idx < static_cast<int>(nodes.size()); idx++) {
+            auto iter = bwdDepth.find(nodes.at(idx)._square.GetMask());
+            if (iter != bwdDepth.end() && iter->second == bwdLayerDepth)
+                tail.back().emplace_back(Link{ Movement::Dir::NONE, nodes.at(idx)._square, idx,
+                                               nodes.at(idx)._numPath });
+        }
+    } else {
+        for (int idx = layer.at(layer.size() - 2); idx < layer.back(); idx++)
+            tail.back().emplace_back(Link{ Movement::Dir::NONE, nodes.at(idx)._square, idx,
+                                           nodes.at(idx)._numPath });
+    }
+
+    // Follow the shortest solutions up to the layer before the solved Squares
+
+    for (int depth = bwdLayerDepth - 1; depth >= 1; depth--) {
+
+        std::vector<Link> next;
+        std::unordered_map<uint64_t, int> found;
+        const std::vector<Link>& curr = tail.back();
+
+        for (int idx = 0; idx < static_cast<int>(curr.size()); idx++) {
+            for (Movement::Dir dir = Movement::Dir::UP;
+                 dir <= Movement::Dir::RIGHT;
+                 dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+                Movement::Result moveRes = Movement::Move(board, curr.at(idx)._square, dir);
+                if (!moveRes.IsSuccess())
+                    continue;
+
+                uint64_t mask = moveRes.GetSquare().GetMask();
+                auto iter = bwdDepth.find(mask);
+                if (iter == bwdDepth.end() || iter->second != depth)
+                    continue;
+
+                auto [foundIter, inserted] = found.try_emplace(mask,
+                                                               static_cast<int>(next.size()));
+                if (!inserted) {
+                    Link& link = next.at(foundIter->second);
+                    link._numPath = std::min(link._numPath + curr.at(idx)._numPath, MAX_NUM_PATH);
+                    continue;
+                }
+
+                next.emplace_back(Link{ dir, moveRes.GetSquare(), idx, curr.at(idx)._numPath });
+            }
+        }
+
+        tail.emplace_back(std::move(next));
+    }
+
+    // Count the paths into a solved Square
+
+    const std::vector<Link>& last = tail.back();
+    int numSol = 0;
+    Link solLink;
+
+    for (int idx = 0; idx < static_cast<int>(last.size()); idx++) {
+        for (Movement::Dir dir = Movement::Dir::UP;
+             dir <= Movement::Dir::RIGHT;
+             dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+            Movement::Result moveRes = Movement::Move(board, last.at(idx)._square, dir);
+            if (!moveRes.IsSuccess() || !moveRes.GetSquare().IsSolved())
+                continue;
+
+            if (numSol == 0)
+                solLink = Link{ dir, moveRes.GetSquare(), idx };
+
+            numSol += last.at(idx)._numPath;
+
+            if (numSol >= MAX_NUM_PATH)
+                return Solution(Solution::Status::SHORTEST_SOLUTION_REPEATED);
+        }
+    }
+
+    assert(numSol == 1);
+
+    // Construct solution
+
+    std::vector<Movement::Dir> retDir;
+    retDir.reserve(solDepth + 1);
+
+    std::vector<Square> retSquare;
+    retSquare.reserve(solDepth + 1);
+
+    retDir.emplace_back(solLink._dir);
+    retSquare.emplace_back(solLink._square);
+
+    int prevLink = solLink._prevLink;
+
+    for (int t = static_cast<int>(tail.size()) - 1; t > 0; t--) {
+        const Link& link = tail.at(t).at(prevLink);
+        retDir.emplace_back(link._dir);
+        retSquare.emplace_back(link._square);
+        prevLink = link._prevLink;
+    }
+
+    int prevNode = tail.front().at(prevLink)._prevLink;
+
+    while (prevNode != -1) {
+        const Node& node = nodes.at(prevNode);
+        retDir.emplace_back(node._dir);
+        retSquare.emplace_back(node._square);
+        prevNode = node._prevNode;
+    }
+
+    std::reverse(retDir.begin(), retDir.end());
+    std::reverse(retSquare.begin(), retSquare.end());
+
+    return Solution(Solution::Status::SOLVED, std::move(retDir), std::move(retSquare), solDepth);
+}
+
+} // namespace Bidirectional
+
+} // namespace Solver
@@ -0,0 +1,26 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef BIDIRECTIONAL_HPP
+#define BIDIRECTIONAL_HPP
+
+#include "Solver.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+namespace Solver
+{
+
+namespace Bidirectional
+{
+
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth);
+
+} // namespace Bidirectional
+
+} // namespace Solver
+
+#endif // BIDIRECTIONAL_HPP
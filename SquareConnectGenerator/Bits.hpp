@@ -0,0 +1,149 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef BITS_HPP
+#define BITS_HPP
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+namespace Bits
+{
+
+// Mask of 128 bits for Boards of more than 64 tiles, as there is no portable
+// 128 bit integer.  Only the operations the masks of a Board need are given.
+class Mask128
+{
+public:
+
+    constexpr Mask128() = default;
+    constexpr Mask128(uint64_t low) : _low(low) { }
+    constexpr Mask128(uint64_t low, uint64_t high) : _low(low), _high(high) { }
+    constexpr Mask128(const Mask128& mask) = default;
+    constexpr Mask128(Mask128&& mask) noexcept = default;
+
+    ~Mask128() = default;
+
+    constexpr Mask128& operator=(const Mask128& mask) = default;
+    constexpr Mask128& operator=(Mask128&& mask) noexcept = default;
+
+    constexpr uint64_t GetLow() const { return _low; }
+    constexpr uint64_t GetHigh() const { return _high; }
+
+    constexpr explicit operator bool() const { return (_low | _high) != 0; }
+    constexpr bool operator==(const Mask128& mask) const = default;
+
+    constexpr Mask128 operator~() const { return Mask128(~_low, ~_high); }
+
+    constexpr Mask128 operator&(const Mask128& mask) const
+    {
+        return Mask128(_low & mask._low, _high & mask._high);
+    }
+
+    constexpr Mask128 operator|(const Mask128& mask) const
+    {
+        return Mask128(_low | mask._low, _high | mask._high);
+    }
+
+    constexpr Mask128 operator^(const Mask128& mask) const
+    {
+        return Mask128(_low ^ mask._low, _high ^ mask._high);
+    }
+
+    constexpr Mask128 operator-(const Mask128& mask) const
+    {
+        uint64_t low = _low - mask._low;
+        return Mask128(low, _high - mask._high - (low > _low ? 1 : 0));
+    }
+
+    constexpr Mask128 operator<<(int shift) const
+    {
+        if (shift == 0)
+            return *this;
+        if (shift >= 64)
+            return Mask128(0, _low << (shift - 64));
+        return Mask128(_low << shift, (_high << shift) | (_low >> (64 - shift)));
+    }
+
+    constexpr Mask128 operator>>(int shift) const
+    {
+        if (shift == 0)
+            return *this;
+        if (shift >= 64)
+            return Mask128(_high >> (shift - 64), 0);
+        return Mask128((_low >> shift) | (_high << (64 - shift)), _high >> shift);
+    }
+
+    constexpr Mask128& operator&=(const Mask128& mask) { return *this = *this & mask; }
+    constexpr Mask128& operator|=(const Mask128& mask) { return *this = *this | mask; }
+    constexpr Mask128& operator^=(const Mask128& mask) { return *this = *this ^ mask; }
+
+private:
+
+    uint64_t _low{ 0 };
+    uint64_t _high{ 0 };
+};
+
+// Smallest mask with a bit for each of numBit bits, so that Boards up to 8x8
+// keep using a single word
+template <int NUM_BIT>
+using Mask = std::conditional_t<(NUM_BIT <= 64), uint64_t, Mask128>;
+
+template <typename MaskType>
+[[nodiscard]] constexpr MaskType GetBit(int bit)
+{
+    return MaskType(1) << bit;
+}
+
+// Mask of the lowest numBit bits
+template <typename MaskType>
+[[nodiscard]] constexpr MaskType GetLowBits(int numBit)
+{
+    return numBit == 8 * static_cast<int>(sizeof(MaskType)) ?
+           ~MaskType(0) : GetBit<MaskType>(numBit) - MaskType(1);
+}
+
+template <typename MaskType>
+[[nodiscard]] constexpr bool IsSet(const MaskType& mask, int bit)
+{
+    return static_cast<bool>((mask >> bit) & MaskType(1));
+}
+
+[[nodiscard]] constexpr int PopCount(uint64_t mask)
+{
+    return std::popcount(mask);
+}
+
+[[nodiscard]] constexpr int PopCount(const Mask128& mask)
+{
+    return std::popcount(mask.GetLow()) + std::popcount(mask.GetHigh());
+}
+
+[[nodiscard]] constexpr int CountrZero(uint64_t mask)
+{
+    return std::countr_zero(mask);
+}
+
+[[nodiscard]] constexpr int CountrZero(const Mask128& mask)
+{
+    return mask.GetLow() ? std::countr_zero(mask.GetLow()) : 64 + std::countr_zero(mask.GetHigh());
+}
+
+// Well mixed upper bits for indexing hash tables by mask
+[[nodiscard]] constexpr uint64_t GetHash(uint64_t mask)
+{
+    return mask * 0x9E3779B97F4A7C15;
+}
+
+[[nodiscard]] constexpr uint64_t GetHash(const Mask128& mask)
+{
+    return (mask.GetLow() ^ (mask.GetHigh() * 0xC2B2AE3D27D4EB4F)) * 0x9E3779B97F4A7C15;
+}
+
+} // namespace Bits
+
+#endif // BITS_HPP
@@ -6,44 +6,178 @@
 
 #include "Board.hpp"
 
-Board::Board(Tile tile) :
-    _tiles{ NUM_TILES, tile }
+#include "Bits.hpp"
+#include "BoardSize.hpp"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+// Row and column delta of a single step of each slide
+static constexpr std::array<int, 4> ROW_STEP{ -1, 1, 0, 0 };
+static constexpr std::array<int, 4> COL_STEP{ 0, 0, -1, 1 };
+
+template <int ROW, int COL>
+static constexpr bool IsWithinBoard(int row, int col)
 {
-    // Invariant check
-    assert(_tiles.size() == NUM_TILES);
+    return row >= 0 && row < ROW && col >= 0 && col < COL;
 }
 
-Board::Board(std::vector<Tile> tiles) :
-    _tiles{ std::move(tiles) }
+template <int ROW, int COL>
+[[nodiscard]] static constexpr std::array<typename BasicBoard<ROW, COL>::Stops, 4>
+ComputeStops(typename BasicBoard<ROW, COL>::Mask walls)
+{
+    using BoardType = BasicBoard<ROW, COL>;
+
+    std::array<typename BoardType::Stops, BoardType::NUM_SLIDE> stops{ };
+
+    for (int slide = 0; slide < BoardType::NUM_SLIDE; slide++) {
+        for (int cell = 0; cell < BoardType::NUM_TILES; cell++) {
+
+            int row = cell / COL;
+            int col = cell % COL;
+
+            while (IsWithinBoard<ROW, COL>(row + ROW_STEP[slide], col + COL_STEP[slide])) {
+                int next = (row + ROW_STEP[slide]) * COL + (col + COL_STEP[slide]);
+                if (Bits::IsSet(walls, next))
+                    break;
+                row += ROW_STEP[slide];
+                col += COL_STEP[slide];
+            }
+
+            stops[slide][cell] = static_cast<int8_t>(row * COL + col);
+        }
+    }
+
+    return stops;
+}
+
+template <int ROW, int COL>
+static constexpr std::array<typename BasicBoard<ROW, COL>::Stops, 4> EMPTY_STOPS =
+    ComputeStops<ROW, COL>(0);
+
+template <int ROW, int COL>
+BasicBoard<ROW, COL>::BasicBoard() :
+    _stops{ EMPTY_STOPS<ROW, COL> }
 {
-    // Invariant check
-    assert(_tiles.size() == NUM_TILES);
+    static_assert(NUM_SLIDE == 4, "Slide steps assume four slides");
+    static_assert(NUM_TILES <= 128, "Cells must fit within a signed byte");
 }
 
-Board::Tile Board::GetTile(const Pos& pos) const
+template <int ROW, int COL>
+BasicBoard<ROW, COL>::BasicBoard(Tile tile) :
+    _walls{ tile == Tile::WALL ? Bits::GetLowBits<Mask>(NUM_TILES) : Mask(0) },
+    _stops{ tile == Tile::WALL ? ComputeStops<ROW, COL>(_walls) : EMPTY_STOPS<ROW, COL> }
+{
+}
+
+template <int ROW, int COL>
+BasicBoard<ROW, COL>::BasicBoard(std::vector<Tile> tiles)
+{
+    // Precondition check
+    assert(tiles.size() == NUM_TILES);
+
+    for (int cell = 0; cell < NUM_TILES; cell++) {
+        if (tiles.at(cell) == Tile::WALL)
+            _walls |= Bits::GetBit<Mask>(cell);
+    }
+
+    _stops = ComputeStops<ROW, COL>(_walls);
+}
+
+template <int ROW, int COL>
+typename BasicBoard<ROW, COL>::Tile BasicBoard<ROW, COL>::GetTile(const Pos& pos) const
 {
     // Precondition check
     assert(pos.GetRow() >= 0 && pos.GetRow() < NUM_ROW);
     assert(pos.GetCol() >= 0 && pos.GetCol() < NUM_COL);
-    // Invariant check
-    assert(_tiles.size() == NUM_TILES);
 
-    return _tiles.at((static_cast<size_t>(pos.GetRow()) * NUM_ROW) +
-                     pos.GetCol());
+    return Bits::IsSet(_walls, GetCell(pos)) ? Tile::WALL : Tile::EMPTY;
 }
 
-Board& Board::SetTile(const Pos& pos, Tile tile)
+template <int ROW, int COL>
+BasicBoard<ROW, COL>& BasicBoard<ROW, COL>::SetTile(const Pos& pos, Tile tile)
 {
     // Precondition check
     assert(pos.GetRow() >= 0 && pos.GetRow() < NUM_ROW);
     assert(pos.GetCol() >= 0 && pos.GetCol() < NUM_COL);
-    // Invariant check
-    assert(_tiles.size() == NUM_TILES);
 
-    _tiles.at((static_cast<size_t>(pos.GetRow()) * NUM_ROW) +
-              pos.GetCol()) = tile;
+    int cell = GetCell(pos);
+    Mask walls = _walls;
 
-    // Invariant check
-    assert(_tiles.size() == NUM_TILES);
+    if (tile == Tile::WALL)
+        _walls |= Bits::GetBit<Mask>(cell);
+    else
+        _walls &= ~Bits::GetBit<Mask>(cell);
+
+    if (_walls != walls)
+        PatchStops(cell);
+
+    // Postcondition check
+    assert(_stops == (ComputeStops<ROW, COL>(_walls)));
     return *this;
 }
+
+template <int ROW, int COL>
+typename BasicBoard<ROW, COL>::Mask BasicBoard<ROW, COL>::GetWallMask() const
+{
+    return _walls;
+}
+
+template <int ROW, int COL>
+const typename BasicBoard<ROW, COL>::Stops& BasicBoard<ROW, COL>::GetStops(int slide) const
+{
+    // Precondition check
+    assert(slide >= 0 && slide < NUM_SLIDE);
+
+    return _stops[slide];
+}
+
+template <int ROW, int COL>
+int BasicBoard<ROW, COL>::GetCell(const Pos& pos)
+{
+    return pos.GetRow() * NUM_COL + pos.GetCol();
+}
+
+template <int ROW, int COL>
+Pos BasicBoard<ROW, COL>::GetPos(int cell)
+{
+    return Pos(cell / NUM_COL, cell % NUM_COL);
+}
+
+// Only the cells behind a changed tile, up to and including the next wall,
+// can have their stop changed.  They either stop right in front of the new
+// wall, or carry on to wherever the freed cell stops.
+template <int ROW, int COL>
+void BasicBoard<ROW, COL>::PatchStops(int cell)
+{
+    bool wall = Bits::IsSet(_walls, cell);
+
+    for (int slide = 0; slide < NUM_SLIDE; slide++) {
+
+        int row = cell / NUM_COL - ROW_STEP[slide];
+        int col = cell % NUM_COL - COL_STEP[slide];
+
+        if (!IsWithinBoard<ROW, COL>(row, col))
+            continue;
+
+        int8_t stop = wall ? static_cast<int8_t>(row * NUM_COL + col) : _stops[slide][cell];
+
+        while (IsWithinBoard<ROW, COL>(row, col)) {
+
+            int behind = row * NUM_COL + col;
+            _stops[slide][behind] = stop;
+
+            if (Bits::IsSet(_walls, behind))
+                break;
+
+            row -= ROW_STEP[slide];
+            col -= COL_STEP[slide];
+        }
+    }
+}
+
+#define INSTANTIATE(ROW, COL) template class BasicBoard<ROW, COL>;
+BOARD_SIZE_LIST(INSTANTIATE)
+#undef INSTANTIATE
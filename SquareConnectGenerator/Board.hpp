@@ -7,18 +7,31 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
 
+#include "Bits.hpp"
 #include "Pos.hpp"
 
+#include <array>
 #include <vector>
+#include <cstdint>
 #include <cassert>
 
-class Board
+// Board of any size listed in BoardSize.hpp.  Board is the 8x8 Board used by
+// the Generator.
+template <int ROW, int COL>
+class BasicBoard
 {
 public:
 
-    static const int NUM_ROW = 8;
-    static const int NUM_COL = 8;
+    static const int NUM_ROW = ROW;
+    static const int NUM_COL = COL;
     static const int NUM_TILES = NUM_ROW * NUM_COL;
+    // Number of slide directions.  Slides are indexed in the same order as
+    // Movement::Dir, less Movement::Dir::NONE (UP, DOWN, LEFT, RIGHT).
+    static const int NUM_SLIDE = 4;
+
+    // A single word up to 8x8, and two words above that
+    using Mask = Bits::Mask<NUM_TILES>;
+    using Stops = std::array<int8_t, NUM_TILES>;
 
     enum class Tile : int
     {
@@ -26,25 +39,46 @@ public:
         WALL,
     };
 
-    Board() = default;
-    Board(Tile tile);
-    Board(std::vector<Tile> tiles);
-    Board(const Board& board) = default;
-    Board(Board&& board) noexcept = default;
+    BasicBoard();
+    BasicBoard(Tile tile);
+    BasicBoard(std::vector<Tile> tiles);
+    BasicBoard(const BasicBoard& board) = default;
+    BasicBoard(BasicBoard&& board) noexcept = default;
 
-    ~Board() = default;
+    ~BasicBoard() = default;
 
-    Board& operator=(const Board& board) = default;
-    Board& operator=(Board&& board) noexcept = default;
+    BasicBoard& operator=(const BasicBoard& board) = default;
+    BasicBoard& operator=(BasicBoard&& board) noexcept = default;
 
     Tile GetTile(const Pos& pos) const;
-    Board& SetTile(const Pos& pos, Tile tile);
+    BasicBoard& SetTile(const Pos& pos, Tile tile);
+
+    Mask GetWallMask() const;
+
+    // Cell at which a lone square starting at a cell comes to rest when it
+    // slides in a direction.  The table is kept up to date by SetTile.
+    const Stops& GetStops(int slide) const;
+
+    // Cells are the row major index of a tile, which is also the bit
+    // position of the tile within a mask.
+    static int GetCell(const Pos& pos);
+    static Pos GetPos(int cell);
 
 private:
 
-    // Use vector array instead of array as the former is movable.
-    // Use 1d array as initialization is faster.
-    std::vector<Tile> _tiles{ NUM_TILES, Tile::EMPTY };
+    // Bit n is set if cell n is a wall.  A mask is used rather than an array
+    // of tiles so that copying and move calculations are cheap.
+    Mask _walls{ 0 };
+
+    // Stop cell for each slide and cell.  The stop of a cell only depends
+    // on the tiles beyond it, so a wall cell keeps the stop it would have
+    // if it were empty.  This lets SetTile patch only the cells behind the
+    // changed tile.
+    std::array<Stops, NUM_SLIDE> _stops;
+
+    void PatchStops(int cell);
 };
 
+using Board = BasicBoard<8, 8>;
+
 #endif // BOARD_HPP
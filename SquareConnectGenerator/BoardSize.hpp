@@ -0,0 +1,30 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef BOARD_SIZE_HPP
+#define BOARD_SIZE_HPP
+
+// Every Board size the templates are instantiated for, as (rows, columns).
+// Each translation unit defining a template expands this with a macro which
+// instantiates it for one size.  Only the 8x8 Board is listed, as it is the
+// only size anything uses: the Generator, the Filter, the Profiler, Symmetry
+// and Solver::Solve only work on it.  The templates themselves hold for any
+// size from 6x6 to 10x10, rectangular ones included, so a size is made
+// available to them by adding it here.  BoardSizeTest is built with
+// BOARD_SIZE_TEST, which instantiates a smaller, a rectangular and a larger
+// size as well, the last above 64 tiles.
+#ifdef BOARD_SIZE_TEST
+#define BOARD_SIZE_LIST(INSTANTIATE) \
+    INSTANTIATE(6, 6) \
+    INSTANTIATE(7, 9) \
+    INSTANTIATE(8, 8) \
+    INSTANTIATE(10, 10)
+#else
+#define BOARD_SIZE_LIST(INSTANTIATE) \
+    INSTANTIATE(8, 8)
+#endif
+
+#endif // BOARD_SIZE_HPP
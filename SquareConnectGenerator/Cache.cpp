@@ -0,0 +1,134 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Cache.hpp"
+
+#include "Solver.hpp"
+#include "Symmetry.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <bit>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace Solver
+{
+
+Cache::Key::Key(const Board& board, const Square& square, Symmetry::Transform transform,
+                Mode mode, size_t memoryLimit) :
+    _walls(Symmetry::ApplyMask(transform, board.GetWallMask())),
+    _cells(Symmetry::Apply(transform, square).GetCells()),
+    _mode(mode),
+    _memoryLimit(memoryLimit)
+{
+}
+
+bool Cache::Key::operator==(const Key& key) const
+{
+    return _walls == key._walls && _cells == key._cells && _mode == key._mode &&
+           _memoryLimit == key._memoryLimit;
+}
+
+size_t Cache::Key::GetHash() const
+{
+    uint64_t cells = std::bit_cast<uint32_t>(_cells);
+
+    uint64_t hash = _walls;
+    hash = (hash ^ (cells << 16) ^ static_cast<uint64_t>(_mode)) * 0x9E3779B97F4A7C15;
+    hash = (hash ^ (hash >> 29) ^ _memoryLimit) * 0xBF58476D1CE4E5B9;
+
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+size_t Cache::KeyHash::operator()(const Key& key) const
+{
+    return key.GetHash();
+}
+
+// Whether a Solution found with one maximum depth is also the Solution for
+// another.  Solver::Solve only reports MAX_DEPTH_REACHED if no shorter
+// solution exists, and reports any other status once a depth at or below the
+// maximum depth decides it.
+[[nodiscard]] static bool IsSolutionValid(const Solution& solution, int solMaxDepth,
+                                          int maxDepth)
+{
+    switch (solution.GetStatus()) {
+    case Solution::Status::SOLVED:
+        return maxDepth >= solution.GetDepth();
+    case Solution::Status::MAX_DEPTH_REACHED:
+        return maxDepth <= solMaxDepth;
+    case Solution::Status::UNSOLVABLE:
+    case Solution::Status::SHORTEST_SOLUTION_REPEATED:
+        return maxDepth >= solMaxDepth;
+    default:
+        return maxDepth == solMaxDepth;
+    }
+}
+
+const Solution* Cache::Find(const Key& key, int maxDepth)
+{
+    auto iter = _index.find(key);
+
+    if (iter == _index.end() ||
+        !IsSolutionValid(_entry.at(iter->second)._solution,
+                         _entry.at(iter->second)._maxDepth, maxDepth)) {
+        _statistics.AddMiss();
+        return nullptr;
+    }
+
+    _statistics.AddHit();
+
+    Entry& entry = _entry.at(iter->second);
+    entry._referenced = true;
+    return &entry._solution;
+}
+
+void Cache::Insert(const Key& key, int maxDepth, const Solution& solution)
+{
+    auto iter = _index.find(key);
+
+    // Replace a Solution found with another maximum depth
+    if (iter != _index.end()) {
+        Entry& entry = _entry.at(iter->second);
+        entry._maxDepth = maxDepth;
+        entry._solution = solution;
+        return;
+    }
+
+    if (static_cast<int>(_entry.size()) < NUM_ENTRY) {
+        _index.emplace(key, static_cast<int>(_entry.size()));
+        _entry.emplace_back(Entry{ key, maxDepth, solution, false });
+        return;
+    }
+
+    // Move the hand past every referenced entry, clearing them on the way
+    while (_entry.at(_hand)._referenced) {
+        _entry.at(_hand)._referenced = false;
+        _hand = (_hand + 1) % NUM_ENTRY;
+    }
+
+    Entry& entry = _entry.at(_hand);
+
+    _index.erase(entry._key);
+    _index.emplace(key, _hand);
+    entry = Entry{ key, maxDepth, solution, false };
+
+    _statistics.AddEviction();
+    _hand = (_hand + 1) % NUM_ENTRY;
+}
+
+CacheStatistics Cache::TakeStatistics()
+{
+    CacheStatistics retStatistics = _statistics;
+    _statistics = CacheStatistics();
+    return retStatistics;
+}
+
+} // namespace Solver
@@ -0,0 +1,110 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include "Solver.hpp"
+#include "Symmetry.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace Solver
+{
+
+// Bounded cache of Solutions.  Once full, entries are evicted with the clock
+// algorithm, where an entry survives one pass of the hand for every time it
+// is looked up.
+//
+// A Solution found with one maximum depth also holds for some others, so the
+// maximum depth is kept with the entry rather than in the Key.  A solved
+// puzzle stays solved with a larger maximum depth, and a puzzle beyond the
+// maximum depth stays beyond a smaller one.
+//
+// Puzzles are kept in their canonical orientation, so a puzzle found in any
+// of its 8 orientations is a hit.  The Solution of a puzzle in another
+// orientation is the Solution transformed the same way.
+class Cache
+{
+public:
+
+    static const int NUM_ENTRY = 1 << 12;
+
+    // Every argument of Solver::Solve but the maximum depth, with the Board and
+    // Square taken by the Transform.  Squares are kept in order, as the order
+    // decides the Squares of the Solution.
+    class Key
+    {
+    public:
+
+        Key() = default;
+        Key(const Board& board, const Square& square, Symmetry::Transform transform, Mode mode,
+            size_t memoryLimit);
+        Key(const Key& key) = default;
+        Key(Key&& key) noexcept = default;
+
+        ~Key() = default;
+
+        Key& operator=(const Key& key) = default;
+        Key& operator=(Key&& key) noexcept = default;
+
+        bool operator==(const Key& key) const;
+
+        size_t GetHash() const;
+
+    private:
+
+        uint64_t _walls{ 0 };
+        Square::Cells _cells{ };
+        Mode _mode{ Mode::BREADTH_FIRST };
+        size_t _memoryLimit{ 0 };
+    };
+
+    Cache() = default;
+    Cache(const Cache& cache) = default;
+    Cache(Cache&& cache) noexcept = default;
+
+    ~Cache() = default;
+
+    Cache& operator=(const Cache& cache) = default;
+    Cache& operator=(Cache&& cache) noexcept = default;
+
+    // Returns nullptr on a miss.  The Solution is valid until the next Insert.
+    const Solution* Find(const Key& key, int maxDepth);
+    void Insert(const Key& key, int maxDepth, const Solution& solution);
+
+    // Statistics since the last take, which start over from none
+    CacheStatistics TakeStatistics();
+
+private:
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        Key _key{ };
+        int _maxDepth{ 0 };
+        Solution _solution{ };
+        bool _referenced{ false };
+    };
+
+    std::vector<Entry> _entry{ };
+    std::unordered_map<Key, int, KeyHash> _index{ };
+    int _hand{ 0 };
+    CacheStatistics _statistics{ };
+};
+
+} // namespace Solver
+
+#endif // CACHE_HPP
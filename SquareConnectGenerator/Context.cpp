@@ -0,0 +1,66 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Context.hpp"
+
+#include "NodeStore.hpp"
+#include "Retrograde.hpp"
+#include "Dynamic.hpp"
+#include "Batch.hpp"
+#include "WorkerPool.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cassert>
+
+namespace Solver
+{
+
+NodeStore<Board::NUM_ROW, Board::NUM_COL>& Context::GetNodeStore(size_t memoryLimit)
+{
+    _nodeStore.Reset(memoryLimit);
+    return _nodeStore;
+}
+
+Dynamic& Context::GetDynamic(const Square& square)
+{
+    _dynamic.Reset(square);
+    return _dynamic;
+}
+
+Batch::Workspace& Context::GetBatchWorkspace()
+{
+    return _batchWorkspace;
+}
+
+Retrograde::Table& Context::GetTable()
+{
+    return _table;
+}
+
+std::vector<Context>& Context::GetHelper(int numHelper)
+{
+    // Precondition check
+    assert(numHelper >= 0);
+
+    if (static_cast<int>(_helper.size()) < numHelper)
+        _helper.resize(numHelper);
+
+    return _helper;
+}
+
+WorkerPool& Context::GetPool()
+{
+    if (!_pool)
+        _pool = std::make_unique<WorkerPool>();
+
+    return *_pool;
+}
+
+} // namespace Solver
@@ -0,0 +1,69 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef CONTEXT_HPP
+#define CONTEXT_HPP
+
+#include "NodeStore.hpp"
+#include "Retrograde.hpp"
+#include "Dynamic.hpp"
+#include "Batch.hpp"
+#include "WorkerPool.hpp"
+#include "Solver.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace Solver
+{
+
+// Storage of the searches made by one thread.  Each search resets the storage
+// it takes from the Context rather than freeing it, so once the storage has
+// grown to fit the largest search, searches stop allocating.  A Context must
+// not be used by more than one thread at a time.
+class Context
+{
+public:
+
+    Context() = default;
+    Context(const Context& context) = delete;
+    Context(Context&& context) noexcept = default;
+
+    ~Context() = default;
+
+    Context& operator=(const Context& context) = delete;
+    Context& operator=(Context&& context) noexcept = default;
+
+    // Nodes of the Breadth First Search, emptied
+    NodeStore<Board::NUM_ROW, Board::NUM_COL>& GetNodeStore(size_t memoryLimit);
+    // Search kept between solves, started over from the Square
+    Dynamic& GetDynamic(const Square& square);
+    Batch::Workspace& GetBatchWorkspace();
+    // Table to be built again for another Board
+    Retrograde::Table& GetTable();
+    // Contexts of the threads which help this one with a search, at least
+    // numHelper of them
+    std::vector<Context>& GetHelper(int numHelper);
+    // Threads which help this one, kept for as long as the Context
+    WorkerPool& GetPool();
+
+private:
+
+    NodeStore<Board::NUM_ROW, Board::NUM_COL> _nodeStore{ DEFAULT_MEMORY_LIMIT };
+    Dynamic _dynamic{ };
+    Batch::Workspace _batchWorkspace{ };
+    Retrograde::Table _table{ };
+    std::vector<Context> _helper{ };
+    // Started on first use, and held by pointer so the Context can be moved
+    std::unique_ptr<WorkerPool> _pool{ };
+};
+
+} // namespace Solver
+
+#endif // CONTEXT_HPP
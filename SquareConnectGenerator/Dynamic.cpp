@@ -0,0 +1,314 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Dynamic.hpp"
+
+#include "Solver.hpp"
+#include "Util.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+#include "Bits.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace Solver
+{
+
+Dynamic::Dynamic(const Square& square)
+{
+    Reset(square);
+}
+
+void Dynamic::Reset(const Square& square)
+{
+    // Precondition check
+    assert(!square.IsSolved());
+
+    _walls = 0;
+    _nodes.clear();
+    _layer.assign(1, 0);
+    _moveCells.clear();
+
+    _slotBit = MIN_SLOT_BIT;
+    _numSlotUsed = 0;
+    _slot.assign(static_cast<size_t>(1) << MIN_SLOT_BIT, 0);
+
+    Insert(square.GetMask(), 0);
+    _nodes.emplace_back(Node{ Movement::Dir::NONE, square, false, -1, 1 });
+}
+
+// A layer only depends on the moves out of the layers before it, so the
+// search is kept up to the first layer whose moves depend on a changed tile.
+// That layer is expanded again, which gives the same nodes in the same order
+// as a fresh Breadth First Search.
+[[nodiscard]] Solution Dynamic::Solve(const Board& board, int maxDepth, size_t memoryLimit)
+{
+    // Precondition check
+    assert(!_nodes.empty());
+    assert(Util::IsBoardSquareSane(board, _nodes.front()._square));
+    assert(maxDepth > 0);
+
+    uint64_t changed = board.GetWallMask() ^ _walls;
+    _walls = board.GetWallMask();
+
+    for (int layer = 0; changed && layer < static_cast<int>(_moveCells.size()); layer++) {
+        if (_moveCells.at(layer) & changed) {
+            Truncate(layer + 1);
+            break;
+        }
+    }
+
+    int solNode = -1;
+    int solDepth = 0;
+
+    for (int depth = 0; solNode < 0; depth++) {
+
+        if (_layer.at(depth) == GetLayerEnd(depth))
+            return Solution(Solution::Status::UNSOLVABLE);
+
+        if (depth + 1 > maxDepth)
+            return Solution(Solution::Status::MAX_DEPTH_REACHED);
+
+        if (depth + 1 == static_cast<int>(_layer.size()) && !Expand(board, memoryLimit))
+            return Solution(Solution::Status::MEMORY_LIMIT_REACHED);
+
+        // Count the paths into the solved nodes of the next layer
+        int numPath = 0;
+
+        for (int idx = _layer.at(depth + 1); idx < GetLayerEnd(depth + 1); idx++) {
+
+            const Node& node = _nodes.at(idx);
+            if (!node._solved)
+                continue;
+
+            if (solNode < 0) {
+                solNode = idx;
+                solDepth = depth + 1;
+            }
+
+            numPath += node._numPath;
+        }
+
+        if (numPath >= MAX_NUM_PATH)
+            return Solution(Solution::Status::SHORTEST_SOLUTION_REPEATED);
+    }
+
+    // Construct solution
+
+    std::vector<Movement::Dir> retDir;
+    retDir.reserve(solDepth + 1);
+
+    std::vector<Square> retSquare;
+    retSquare.reserve(solDepth + 1);
+
+    int prevNode = solNode;
+
+    do {
+        const Node& n = _nodes.at(prevNode);
+
+        // Invariant check
+        assert(n._numPath == 1);
+
+        retDir.emplace_back(n._dir);
+        retSquare.emplace_back(n._square);
+
+        prevNode = n._prevNode;
+
+    } while (prevNode != -1);
+
+    std::reverse(retDir.begin(), retDir.end());
+    std::reverse(retSquare.begin(), retSquare.end());
+
+    return Solution(Solution::Status::SOLVED, std::move(retDir), std::move(retSquare), solDepth);
+}
+
+[[nodiscard]] uint64_t Dynamic::GetMoveCells(int numLayer) const
+{
+    // Precondition check
+    assert(numLayer >= 0 && numLayer <= static_cast<int>(_moveCells.size()));
+
+    uint64_t retCells = 0;
+
+    for (int layer = 0; layer < numLayer; layer++)
+        retCells |= _moveCells.at(layer);
+
+    return retCells;
+}
+
+int Dynamic::GetLayerEnd(int layer) const
+{
+    if (layer + 1 < static_cast<int>(_layer.size()))
+        return _layer.at(layer + 1);
+
+    return static_cast<int>(_nodes.size());
+}
+
+size_t Dynamic::GetInsertMemory() const
+{
+    size_t numNode = _nodes.size() + 1;
+    size_t numSlot = _slot.size();
+
+    if (2 * (static_cast<size_t>(_numSlotUsed) + 1) > numSlot)
+        numSlot = static_cast<size_t>(1) << GetRehashSlotBit(numNode - 1);
+
+    return numNode * sizeof(Node) + numSlot * sizeof(uint32_t);
+}
+
+// Table at most a quarter full once numNode nodes are inserted again
+int Dynamic::GetRehashSlotBit(size_t numNode)
+{
+    int retSlotBit = MIN_SLOT_BIT;
+    while ((static_cast<size_t>(1) << retSlotBit) < 4 * (numNode + 1))
+        retSlotBit++;
+
+    return retSlotBit;
+}
+
+size_t Dynamic::GetSlot(uint64_t mask) const
+{
+    return static_cast<size_t>(Bits::GetHash(mask) >> (64 - _slotBit));
+}
+
+// A slot whose node has been truncated does not end the probe, as nodes added
+// after it may have been placed beyond it
+int Dynamic::Find(uint64_t mask) const
+{
+    for (size_t slot = GetSlot(mask); ; slot = (slot + 1) & (_slot.size() - 1)) {
+
+        uint32_t value = _slot[slot];
+        if (value == 0)
+            return -1;
+
+        int idx = static_cast<int>(value - 1);
+        if (idx < static_cast<int>(_nodes.size()) && _nodes[idx]._square.GetMask() == mask)
+            return idx;
+    }
+}
+
+// The node is added right after, so idx is the number of nodes and any slot
+// of a truncated node at or beyond it is taken over
+void Dynamic::Insert(uint64_t mask, int idx)
+{
+    // Precondition check
+    assert(idx == static_cast<int>(_nodes.size()));
+
+    // Keep the table at most half full, counting the slots of truncated nodes
+    if (2 * (static_cast<size_t>(_numSlotUsed) + 1) > _slot.size())
+        Rehash();
+
+    size_t slot = GetSlot(mask);
+
+    while (_slot[slot] != 0 && static_cast<int>(_slot[slot] - 1) < idx)
+        slot = (slot + 1) & (_slot.size() - 1);
+
+    if (_slot[slot] == 0)
+        _numSlotUsed++;
+
+    _slot[slot] = static_cast<uint32_t>(idx + 1);
+}
+
+// Insert every node again into a table at most a quarter full, which drops
+// the slots of truncated nodes
+void Dynamic::Rehash()
+{
+    size_t numNode = _nodes.size();
+
+    _slotBit = GetRehashSlotBit(numNode);
+
+    _slot.assign(static_cast<size_t>(1) << _slotBit, 0);
+    _numSlotUsed = 0;
+
+    for (size_t idx = 0; idx < numNode; idx++) {
+
+        size_t slot = GetSlot(_nodes[idx]._square.GetMask());
+        while (_slot[slot] != 0)
+            slot = (slot + 1) & (_slot.size() - 1);
+
+        _slot[slot] = static_cast<uint32_t>(idx + 1);
+        _numSlotUsed++;
+    }
+}
+
+// Expand the last layer in the same order as Solver::Solve.  The nodes of a
+// layer cut short by the memory limit are dropped again, as are any path
+// counts it added, as only the nodes it added gained any.
+bool Dynamic::Expand(const Board& board, size_t memoryLimit)
+{
+    int begin = _layer.back();
+    int end = static_cast<int>(_nodes.size());
+    // Cells taken up by a square in any node of the layer
+    uint64_t occupied = 0;
+
+    _layer.emplace_back(end);
+
+    for (int idx = begin; idx < end; idx++) {
+
+        if (_nodes.at(idx)._solved)
+            continue;
+
+        const Square square = _nodes.at(idx)._square;
+        int numPath = _nodes.at(idx)._numPath;
+
+        occupied |= square.GetMask();
+
+        Movement::ResultAll moveRes = Movement::MoveAll(board, square);
+
+        for (Movement::Dir dir = Movement::Dir::UP;
+             dir <= Movement::Dir::RIGHT;
+             dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+            if (!moveRes.IsSuccess(dir))
+                continue;
+
+            const Square newSquare = moveRes.GetSquare(dir);
+
+            uint64_t newMask = newSquare.GetMask();
+            int found = Find(newMask);
+
+            if (found >= 0) {
+                // Paths through an earlier layer are not shortest paths
+                if (found >= end) {
+                    Node& node = _nodes.at(found);
+                    node._numPath = std::min(node._numPath + numPath, MAX_NUM_PATH);
+                }
+                continue;
+            }
+
+            if (GetInsertMemory() > memoryLimit) {
+                _nodes.resize(end);
+                _layer.pop_back();
+                return false;
+            }
+
+            Insert(newMask, static_cast<int>(_nodes.size()));
+            _nodes.emplace_back(Node{ dir, newSquare, newSquare.IsSolved(), idx, numPath });
+        }
+    }
+
+    _moveCells.emplace_back(Movement::GetMoveCells(board, occupied));
+    return true;
+}
+
+// Keep the first numLayer layers, where the last layer kept is no longer
+// expanded
+void Dynamic::Truncate(int numLayer)
+{
+    // Precondition check
+    assert(numLayer > 0 && numLayer < static_cast<int>(_layer.size()));
+
+    int end = _layer.at(numLayer);
+
+    _nodes.resize(end);
+    _layer.resize(numLayer);
+    _moveCells.resize(numLayer - 1);
+}
+
+} // namespace Solver
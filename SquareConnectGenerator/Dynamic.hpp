@@ -0,0 +1,101 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef DYNAMIC_HPP
+#define DYNAMIC_HPP
+
+#include "Solver.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Solver
+{
+
+// Breadth First Search from a single Square which is kept between solves, so
+// that the same Square can be solved again as the Board changes.  Only the
+// layers which depend on a changed tile are searched again, and the same
+// Solution as Solver::Solve is returned.  The memory limit is counted over
+// the nodes and the table of the search, much as Solver::Solve counts it,
+// so either may reach it somewhat sooner than the other.
+class Dynamic
+{
+public:
+
+    Dynamic() = default;
+    Dynamic(const Square& square);
+    Dynamic(const Dynamic& dynamic) = default;
+    Dynamic(Dynamic&& dynamic) noexcept = default;
+
+    ~Dynamic() = default;
+
+    Dynamic& operator=(const Dynamic& dynamic) = default;
+    Dynamic& operator=(Dynamic&& dynamic) noexcept = default;
+
+    // Start over from a Square, keeping the storage of the earlier search
+    void Reset(const Square& square);
+
+    [[nodiscard]] Solution Solve(const Board& board, int maxDepth,
+                                 size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+    // Cells which the moves out of the first numLayer layers depend on.  A
+    // Solution of some depth depends on no tiles but those of the layers
+    // before it, so walling any other empty tile leaves it as it is.
+    [[nodiscard]] uint64_t GetMoveCells(int numLayer) const;
+
+private:
+
+    static const int MIN_SLOT_BIT = 10;
+
+    struct Node
+    {
+        Movement::Dir _dir{ Movement::Dir::NONE };
+        Square _square{ };
+        bool _solved{ false };
+        int _prevNode{ -1 };
+        int _numPath{ 1 };
+    };
+
+    uint64_t _walls{ 0 };
+    std::vector<Node> _nodes{ };
+    // Index of the first node of each layer.  Every layer but the last has
+    // been expanded into the layer after it.
+    std::vector<int> _layer{ };
+    // Cells which the moves out of each expanded layer depend on
+    std::vector<uint64_t> _moveCells{ };
+    // Open addressing table of one more than the node index of each Square
+    // cell mask, where 0 is an empty slot.  Truncated nodes are left behind
+    // in the table, and are told apart by their index or their cell mask.
+    int _slotBit{ MIN_SLOT_BIT };
+    int _numSlotUsed{ 0 };
+    std::vector<uint32_t> _slot{ };
+
+    int GetLayerEnd(int layer) const;
+
+    // Bytes taken once one more node is inserted, counting the Rehash it may
+    // take
+    size_t GetInsertMemory() const;
+    static int GetRehashSlotBit(size_t numNode);
+
+    size_t GetSlot(uint64_t mask) const;
+    // Index of the node with the cell mask, or -1 if there is none
+    int Find(uint64_t mask) const;
+    void Insert(uint64_t mask, int idx);
+    void Rehash();
+
+    // Returns false, with the layer left unexpanded, if the nodes it adds
+    // would exceed the memory limit
+    bool Expand(const Board& board, size_t memoryLimit);
+    void Truncate(int numLayer);
+};
+
+} // namespace Solver
+
+#endif // DYNAMIC_HPP
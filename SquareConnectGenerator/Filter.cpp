@@ -63,6 +63,18 @@ void Filter::AddEntry(const std::string& title,
     return -1;
 }
 
+[[nodiscard]] bool Filter::MatchStart(const Square& square) const
+{
+    Profiler::TypeCount typeCnt = Profiler::CountType(square);
+
+    for (const Entry& ent : _entry) {
+        if (ent._profile != nullptr && Profiler::MatchType(typeCnt, *(ent._profile), 0))
+            return true;
+    }
+
+    return false;
+}
+
 int Filter::GetNumEntry() const
 {
     return static_cast<int>(_entry.size());
@@ -73,6 +85,16 @@ const std::string& Filter::GetEntryTitle(int num) const
     return _entry.at(num)._title;
 }
 
+int Filter::GetEntryDepth(int num) const
+{
+    return _entry.at(num)._depth;
+}
+
+const Profiler::MatchProfile* Filter::GetEntryProfile(int num) const
+{
+    return _entry.at(num)._profile.get();
+}
+
 int Filter::GetMaxDepth() const
 {
     return _maxDepth;
@@ -36,9 +36,16 @@ public:
     [[nodiscard]] int MatchFilter(const Board& board, const Square& square,
                                   const Solver::Solution& solution) const;
 
+    // Whether any entry can match a solution from the Square, which is all
+    // that can be told of it before walls are placed.  The first entry of a
+    // MatchProfile is the start Square, whose Islands must have its Types.
+    [[nodiscard]] bool MatchStart(const Square& square) const;
+
     int GetNumEntry() const;
 
     const std::string& GetEntryTitle(int num) const;
+    int GetEntryDepth(int num) const;
+    const Profiler::MatchProfile* GetEntryProfile(int num) const;
 
     int GetMaxDepth() const;
 
@@ -6,19 +6,68 @@
 
 #include "Generator.hpp"
 
+#include "Retrograde.hpp"
+#include "Context.hpp"
+#include "WorkerPool.hpp"
+#include "Dynamic.hpp"
+#include "Batch.hpp"
 #include "Util.hpp"
+#include "Random.hpp"
+#include "WallSchedule.hpp"
+#include "KeySet.hpp"
+#include "Symmetry.hpp"
 #include "Filter.hpp"
+#include "Profiler.hpp"
 #include "Solver.hpp"
+#include "Movement.hpp"
 #include "Board.hpp"
 #include "Square.hpp"
 #include "Pos.hpp"
 
 #include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cassert>
 #include <iostream>
 
 namespace Generator
 {
 
+// Do not attempt so solve before 5% of the number of available tiles
+// as the puzzle very likely not solvable or meet any filter criterias.
+static const int MIN_WALL = static_cast<int>(0.05 * Board::NUM_TILES);
+// Do not generate any more than 80% of the number of available tiles
+// as the puzzle would very likely not be solvable or meet any filter
+// criterias.
+static const int MAX_WALL = static_cast<int>(0.8 * Board::NUM_TILES);
+// Start Squares drawn for an attempt before it gives up on finding one which a
+// Filter entry accepts
+static const int START_MAX_DRAW = 1024;
+// Reverse walks are made this many times on each Board
+static const int REVERSE_WALK_PER_BOARD = 32;
+// Squares a reverse walk may walk back from before it gives up
+static const int REVERSE_WALK_MAX_EXPAND = 4096;
+// Wall probes solve every this many wall counts at first
+static const int PROBE_STRIDE = 3;
+// Wall probe attempts which are also scanned at every wall count, one in this
+// many
+static const long long PROBE_AUDIT_INTERVAL = 64;
+// With a WallSchedule, the wall scan and probe only solve the range of wall
+// counts which holds this share of the match rates drawn from it
+static const double SCAN_MASS = 0.9;
+// Retrograde candidates are solved this many at a time.  Few of them match a
+// Filter, so the candidates solved beyond a match are seldom wasted.
+static const size_t RETROGRADE_BATCH = 256;
+
+static std::atomic<long long> _probeAttempt{ 0 };
+static std::mutex _probeMutex;
+static ProbeStatistics _probeStatistics;
+
 Product::Product(Status status, int filterNum,
                  Board board, Square square,
                  Solver::Solution solution) :
@@ -53,7 +102,45 @@ const Solver::Solution& Product::GetSolution() const
     return _solution;
 }
 
-[[nodiscard]] static Square GenerateSquare()
+long long ProbeStatistics::GetAttempt() const
+{
+    return _attempt;
+}
+
+long long ProbeStatistics::GetSolve() const
+{
+    return _solve;
+}
+
+long long ProbeStatistics::GetAudit() const
+{
+    return _audit;
+}
+
+long long ProbeStatistics::GetAuditMatch() const
+{
+    return _auditMatch;
+}
+
+long long ProbeStatistics::GetAuditLost() const
+{
+    return _auditLost;
+}
+
+void ProbeStatistics::AddAttempt(long long numSolve)
+{
+    _attempt++;
+    _solve += numSolve;
+}
+
+void ProbeStatistics::AddAudit(bool isMatched, bool isLost)
+{
+    _audit++;
+    _auditMatch += isMatched ? 1 : 0;
+    _auditLost += isLost ? 1 : 0;
+}
+
+[[nodiscard]] static Square GenerateSquare(Random& random)
 {
     while (1) {
 
@@ -66,8 +153,8 @@ const Solver::Solution& Product::GetSolution() const
 
             while (1) {
 
-                Pos pos(Util::GetRandomInt(0, Board::NUM_ROW - 1),
-                    Util::GetRandomInt(0, Board::NUM_COL - 1));
+                Pos pos(random.GetInt(0, Board::NUM_ROW - 1),
+                    random.GetInt(0, Board::NUM_COL - 1));
 
                 found = false;
 
@@ -91,7 +178,22 @@ const Solver::Solution& Product::GetSolution() const
     }
 }
 
-[[nodiscard]] static std::vector<int> GenerateWallStack()
+// Start Square which some Filter entry accepts.  Drawing again until one does
+// samples the starts the entries accept as evenly as GenerateSquare samples
+// them all, and a start no entry accepts never costs a wall scan.  Returns
+// false if START_MAX_DRAW Squares were all rejected.
+[[nodiscard]] static bool GenerateStartSquare(const Filter& filter, Random& random, Square& square)
+{
+    for (int draw = 0; draw < START_MAX_DRAW; draw++) {
+        square = GenerateSquare(random);
+        if (filter.MatchStart(square))
+            return true;
+    }
+
+    return false;
+}
+
+[[nodiscard]] static std::vector<int> GenerateWallStack(Random& random)
 {
     std::vector<int> retWall;
     retWall.reserve(Board::NUM_TILES);
@@ -102,13 +204,49 @@ const Solver::Solution& Product::GetSolution() const
     int numSwap = Board::NUM_TILES / 2;
 
     for (int num = 0; num < numSwap; num++) {
-        std::swap(retWall.at(Util::GetRandomInt(0, Board::NUM_TILES - 1)),
-            retWall.at(Util::GetRandomInt(0, Board::NUM_TILES - 1)));
+        std::swap(retWall.at(random.GetInt(0, Board::NUM_TILES - 1)),
+            retWall.at(random.GetInt(0, Board::NUM_TILES - 1)));
     }
 
     return retWall;
 }
 
+// WallSchedule to draw the wall counts from, which is none if there is no
+// WallSchedule or it only learns
+[[nodiscard]] static const WallSchedule* GetDrawSchedule(const WallSchedule* schedule)
+{
+    return schedule != nullptr && schedule->IsDrawn() ? schedule : nullptr;
+}
+
+// Board with a random number of walls from the top of a wall stack, which the
+// WallSchedule draws if it is drawn from
+[[nodiscard]] static Board GenerateBoard(Random& random, const WallSchedule* schedule, int& numWall)
+{
+    const WallSchedule* drawSchedule = GetDrawSchedule(schedule);
+
+    std::vector<int> wall = GenerateWallStack(random);
+    numWall = drawSchedule != nullptr ? drawSchedule->Draw(random, MIN_WALL, MAX_WALL) :
+                                        random.GetInt(MIN_WALL, MAX_WALL);
+    Board retBrd;
+
+    for (int wallCnt = 0; wallCnt < numWall; wallCnt++)
+        retBrd.SetTile(Board::GetPos(wall.at(wallCnt)), Board::Tile::WALL);
+
+    return retBrd;
+}
+
+// Square on the cells of a mask, with the squares in a random order, as a
+// mask does not tell squares apart
+[[nodiscard]] static Square GenerateSquare(uint64_t mask, Random& random)
+{
+    Square::Cells cells = Square::FromMask(mask).GetCells();
+
+    for (int num = Square::NUM - 1; num > 0; num--)
+        std::swap(cells[num], cells[random.GetInt(0, num)]);
+
+    return Square(cells);
+}
+
 void FillUnreachableTiles(Board& board, const Square& square)
 {
     // Precondition check
@@ -154,85 +292,837 @@ void FillUnreachableTiles(Board& board, const Square& square)
     board = std::move(retBrd);
 }
 
-void FillInconsequentialTiles(Board& board, const Solver::Solution& solution)
+// Replay the Movement::Dir set of a Solution on a Board, and check that the
+// Squares still end up where they do in the Solution.
+[[nodiscard]] static bool IsSolutionReplayed(const Board& board, const Solver::Solution& solution)
+{
+    const std::vector<Movement::Dir>& dir = solution.GetDir();
+    const std::vector<Square>& sqr = solution.GetSquare();
+
+    for (int dep = 1; dep <= solution.GetDepth(); dep++) {
+
+        Movement::Result moveRes = Movement::Move(board, sqr.at(dep - 1), dir.at(dep));
+        if (!moveRes.IsSuccess() ||
+            moveRes.GetSquare().GetCells() != sqr.at(dep).GetCells())
+            return false;
+    }
+
+    return true;
+}
+
+// A tile is inconsequential if the Solution is unchanged once it is a wall.
+// The search of the Board tells which tiles its moves depend on, and any other
+// tile is walled without a solve, as the search would be the same with it
+// walled.  Replaying the Solution rules out most of the tiles left without
+// solving.  Otherwise the Solution still reaches a solved Square with the same
+// depth, so it is unchanged as long as it is the only shortest solution.
+//
+// The tiles left after the replay are solved numThread at a time, each with
+// only its own wall added to the Board.  The tiles before the first one which
+// becomes a wall are decided as they would be one at a time, and the rest are
+// tried again with the new wall, so the Board ends up the same however many
+// threads are used.  Should the search reach the memory limit, the tiles
+// walled so far are kept and the rest are left empty.
+void FillInconsequentialTiles(Board& board, const Solver::Solution& solution,
+                              Solver::Context& context, int numThread)
 {
-    for (int r = 0; r < Board::NUM_ROW; r++) {
-        for (int c = 0; c < Board::NUM_COL; c++) {
-            
-            Pos p(r, c);
+    // Precondition check
+    assert(numThread > 0);
+
+    const Square& sqr = solution.GetSquare().at(0);
+    int depth = solution.GetDepth();
+
+    // The search is kept on this thread, which solves the first tile of
+    // each window with it, and brought up to date as walls are added
+    Solver::Dynamic& dyn = context.GetDynamic(sqr);
+    Solver::Solution sol = dyn.Solve(board, depth);
+
+    if (sol.GetStatus() == Solver::Solution::Status::MEMORY_LIMIT_REACHED)
+        return;
+
+    // Invariant check
+    assert(sol.GetStatus() == Solver::Solution::Status::SOLVED && sol.GetDepth() == depth);
+
+    uint64_t moveCells = dyn.GetMoveCells(depth);
+
+    std::vector<Pos> tile;
+    tile.reserve(numThread);
+    std::vector<char> isWall(numThread);
+
+    std::vector<Solver::Context>& helper = context.GetHelper(numThread - 1);
+
+    int cell = 0;
+
+    while (cell < Board::NUM_TILES) {
+
+        tile.clear();
+
+        for (; cell < Board::NUM_TILES && static_cast<int>(tile.size()) < numThread; cell++) {
+
+            Pos p = Board::GetPos(cell);
 
             if (board.GetTile(p) == Board::Tile::WALL)
                 continue;
 
-            const std::vector<Square>& sqr = solution.GetSquare();
-            if (sqr.at(0).IsPosSquare(p) >= 0)
+            if (sqr.IsPosSquare(p) >= 0)
+                continue;
+
+            // A tile after one still to be solved may yet be depended on
+            // once that one becomes a wall
+            if (!(moveCells & (uint64_t(1) << cell))) {
+                if (!tile.empty())
+                    break;
+
+                board.SetTile(p, Board::Tile::WALL);
                 continue;
+            }
 
             board.SetTile(p, Board::Tile::WALL);
+            bool isReplayed = IsSolutionReplayed(board, solution);
+            board.SetTile(p, Board::Tile::EMPTY);
 
-            Solver::Solution sol = Solver::Solve(board, sqr.at(0), solution.GetDepth());
-            if (sol != solution)
-                board.SetTile(p, Board::Tile::EMPTY);
+            if (isReplayed)
+                tile.emplace_back(p);
+        }
+
+        context.GetPool().Run(static_cast<int>(tile.size()), numThread, [&](int num, int worker) {
+
+            Board brd = board;
+            brd.SetTile(tile.at(num), Board::Tile::WALL);
+
+            Solver::Solution sol = worker == 0 ?
+                dyn.Solve(brd, depth) :
+                Solver::Solve(brd, sqr, depth, helper.at(worker - 1));
+            isWall.at(num) = (sol.GetStatus() == Solver::Solution::Status::SOLVED &&
+                              sol.GetDepth() == depth);
+        });
+
+        for (int num = 0; num < static_cast<int>(tile.size()); num++) {
+            if (isWall.at(num)) {
+                board.SetTile(tile.at(num), Board::Tile::WALL);
+                cell = Board::GetCell(tile.at(num)) + 1;
+
+                if (dyn.Solve(board, depth).GetStatus() ==
+                    Solver::Solution::Status::MEMORY_LIMIT_REACHED)
+                    return;
+
+                moveCells = dyn.GetMoveCells(depth);
+                break;
+            }
         }
     }
 }
 
-[[nodiscard]] Product Generate(const Filter& filter)
+// Product of a match, with the tiles which make no difference filled.  With a
+// KeySet, the match is claimed before the fill, and so is the filled puzzle if
+// the fill changed it.  A match which either claim finds there already is a
+// duplicate, of which a FAIL Product is made instead.  Every mode ends the
+// attempt with its first match, duplicate or not, so a duplicate is only ever
+// a puzzle Output would drop, and which puzzles a run writes does not depend
+// on which thread claims first.
+[[nodiscard]] static Product MakeMatchProduct(int filterNum, Board board, Square square,
+                                              Solver::Solution solution,
+                                              Solver::Context& context, int numThread,
+                                              KeySet* keySet)
+{
+    Symmetry::Key key{ };
+
+    if (keySet != nullptr) {
+        key = Symmetry::GetCanonicalKey(board, square);
+        if (!keySet->Claim(key))
+            return Product(Product::Status::FAIL);
+    }
+
+    FillInconsequentialTiles(board, solution, context, numThread);
+    FillUnreachableTiles(board, square);
+
+    if (keySet != nullptr) {
+        Symmetry::Key fillKey = Symmetry::GetCanonicalKey(board, square);
+        if (fillKey != key && !keySet->Claim(fillKey))
+            return Product(Product::Status::FAIL);
+    }
+
+    return Product(Product::Status::SUCCESS, filterNum,
+                   std::move(board), std::move(square),
+                   std::move(solution));
+}
+
+// What a thread of the wall scan keeps between the wall counts it solves
+struct ScanWorker
+{
+    // Board with the first _numWall walls of the wall stack
+    Board _board{ };
+    int _numWall{ 0 };
+    Solver::Solution _lastSol{ };
+
+    // Smallest wall count at which the thread matched the Filter
+    int _matchCnt{ MAX_WALL + 1 };
+    int _filNum{ -1 };
+    Board _matchBoard{ };
+    Solver::Solution _matchSol{ };
+};
+
+// Square and wall stack of a wall scan, with a ScanWorker and a Dynamic search
+// for each thread
+class Scan
+{
+public:
+
+    Scan(Square square, std::vector<int> wall, Solver::Context& context, int numThread);
+    Scan(const Scan& scan) = delete;
+    Scan(Scan&& scan) = delete;
+
+    ~Scan() = default;
+
+    Scan& operator=(const Scan& scan) = delete;
+    Scan& operator=(Scan&& scan) = delete;
+
+    // Wall counts from minWall to maxWall, less those whose last wall falls
+    // on the Square, as they give the Board of the count before
+    [[nodiscard]] std::vector<int> GetWallCount(int minWall, int maxWall) const;
+
+    // Solve the Board of each wall count, which are taken in order by the
+    // next free thread, and return the status of each.  A count is only
+    // solved if no smaller count has matched the Filter yet, and is otherwise
+    // left with Solver::Solution::Status::NONE.  Each count which was solved
+    // is added to the WallSchedule, if there is one, as a match of the Filter
+    // entry it matched, if any, and the counts which were not are left out.
+    // Which counts beyond the smallest match are solved, and so added,
+    // depends on the timing of the threads.
+    [[nodiscard]] std::vector<Solver::Solution::Status> Solve(const Filter& filter,
+                                                              const std::vector<int>& wallCnt,
+                                                              WallSchedule* schedule);
+
+    // Start over, as though no wall count had been solved
+    void Reset();
+
+    // The Product of the smallest wall count which matched the Filter
+    [[nodiscard]] Product MakeProduct(KeySet* keySet);
+
+    // Smallest wall count which matched the Filter, or more than MAX_WALL
+    [[nodiscard]] int GetMatchCount() const;
+
+private:
+
+    Square _square;
+    std::vector<int> _wall;
+    Solver::Context& _context;
+    int _numThread;
+
+    std::vector<ScanWorker> _worker;
+    std::vector<Solver::Dynamic*> _dyn;
+};
+
+Scan::Scan(Square square, std::vector<int> wall, Solver::Context& context, int numThread) :
+    _square(std::move(square)), _wall(std::move(wall)), _context(context),
+    _numThread(numThread), _worker(numThread), _dyn(numThread)
 {
     // Precondition check
-    assert(filter.GetNumEntry() > 0);
+    assert(numThread > 0);
 
-    Square sqr = GenerateSquare();
-    Board brd;
+    Reset();
+}
 
-    std::vector<int> wall = GenerateWallStack();
-    // Do not attempt so solve before 5% of the number of available tiles
-    // as the puzzle very likely not solvable or meet any filter criterias.
-    int minWall = static_cast<int>(0.05 * Board::NUM_TILES);
-    // Do not generate any more than 80% of the number of available tiles
-    // as the puzzle would very likely not be solvable or meet any filter
-    // criterias.
-    int maxWall = static_cast<int>(0.8 * Board::NUM_TILES);
-    int wallCnt = 0;
+[[nodiscard]] std::vector<int> Scan::GetWallCount(int minWall, int maxWall) const
+{
+    // Precondition check
+    assert(minWall >= MIN_WALL && minWall <= maxWall && maxWall <= MAX_WALL);
 
-    Solver::Solution lastSol;
+    std::vector<int> retCnt;
+    retCnt.reserve(maxWall - minWall + 1);
 
-    while (wallCnt < maxWall) {
+    for (int wallCnt = minWall; wallCnt <= maxWall; wallCnt++) {
+        if (_square.IsPosSquare(Board::GetPos(_wall.at(wallCnt - 1))) < 0)
+            retCnt.emplace_back(wallCnt);
+    }
 
-        Pos pos(wall.at(wallCnt) / Board::NUM_ROW,
-                wall.at(wallCnt) % Board::NUM_ROW);
-        wallCnt++;
+    return retCnt;
+}
 
-        if (sqr.IsPosSquare(pos) >= 0)
-            continue;
+[[nodiscard]] std::vector<Solver::Solution::Status> Scan::Solve(const Filter& filter,
+                                                                const std::vector<int>& wallCnt,
+                                                                WallSchedule* schedule)
+{
+    std::vector<Solver::Solution::Status> retStatus(wallCnt.size(),
+                                                    Solver::Solution::Status::NONE);
+    // Filter entry which the Board of each count matched, if any
+    std::vector<int> filterNum(wallCnt.size(), -1);
+    std::atomic<int> matchCnt{ GetMatchCount() };
 
-        brd.SetTile(pos, Board::Tile::WALL);
+    _context.GetPool().Run(static_cast<int>(wallCnt.size()), _numThread,
+                           [&](int num, int workerNum) {
 
-        if (wallCnt < minWall)
-            continue;
+        int cnt = wallCnt.at(num);
+        if (cnt > matchCnt.load(std::memory_order_relaxed))
+            return;
+
+        ScanWorker& work = _worker.at(workerNum);
+
+        // Walls are added a few at a time, so most of the search of a thread
+        // is kept from one solve to the next.
+        if (work._numWall > cnt) {
+            work._board = Board();
+            work._numWall = 0;
+        }
+
+        for (; work._numWall < cnt; work._numWall++) {
+
+            Pos p = Board::GetPos(_wall.at(work._numWall));
+
+            if (_square.IsPosSquare(p) < 0)
+                work._board.SetTile(p, Board::Tile::WALL);
+        }
+
+        Solver::Solution sol = _dyn.at(workerNum)->Solve(work._board, filter.GetMaxDepth());
+        retStatus.at(num) = sol.GetStatus();
 
-        Solver::Solution sol = Solver::Solve(brd, sqr, filter.GetMaxDepth());
         if (sol.GetStatus() != Solver::Solution::Status::SOLVED)
-            continue;
+            return;
 
         // Do not perform filter matching if the solution is the same as before
         // to avoid wasting processing time.
-        if (sol == lastSol)
+        if (sol == work._lastSol)
+            return;
+
+        int filNum = filter.MatchFilter(work._board, _square, sol);
+        if (filNum < 0) {
+            work._lastSol = std::move(sol);
+            return;
+        }
+
+        filterNum.at(num) = filNum;
+
+        if (cnt < work._matchCnt) {
+            work._matchCnt = cnt;
+            work._filNum = filNum;
+            work._matchBoard = work._board;
+            work._matchSol = std::move(sol);
+        }
+
+        int match = matchCnt.load(std::memory_order_relaxed);
+        while (cnt < match && !matchCnt.compare_exchange_weak(match, cnt,
+                                                              std::memory_order_relaxed)) {
+        }
+    });
+
+    if (schedule != nullptr) {
+        for (size_t num = 0; num < wallCnt.size(); num++) {
+            if (retStatus.at(num) != Solver::Solution::Status::NONE)
+                schedule->Add(wallCnt.at(num), filterNum.at(num));
+        }
+    }
+
+    return retStatus;
+}
+
+void Scan::Reset()
+{
+    std::vector<Solver::Context>& helper = _context.GetHelper(_numThread - 1);
+
+    _dyn.at(0) = &_context.GetDynamic(_square);
+    for (int num = 1; num < _numThread; num++)
+        _dyn.at(num) = &helper.at(num - 1).GetDynamic(_square);
+
+    for (ScanWorker& work : _worker)
+        work = ScanWorker();
+}
+
+[[nodiscard]] Product Scan::MakeProduct(KeySet* keySet)
+{
+    auto match = std::min_element(_worker.begin(), _worker.end(),
+                                  [](const ScanWorker& a, const ScanWorker& b) {
+        return a._matchCnt < b._matchCnt;
+    });
+
+    if (match->_matchCnt > MAX_WALL)
+        return Product(Product::Status::FAIL);
+
+    return MakeMatchProduct(match->_filNum, std::move(match->_matchBoard), _square,
+                            std::move(match->_matchSol), _context, _numThread, keySet);
+}
+
+[[nodiscard]] int Scan::GetMatchCount() const
+{
+    int retCnt = MAX_WALL + 1;
+
+    for (const ScanWorker& work : _worker)
+        retCnt = std::min(retCnt, work._matchCnt);
+
+    return retCnt;
+}
+
+// Wall counts a scan solves, which are every count from MIN_WALL to MAX_WALL,
+// or the range the WallSchedule draws if it is drawn from
+static void DrawScanRange(Random& random, const WallSchedule* schedule,
+                          int& minWall, int& maxWall)
+{
+    const WallSchedule* drawSchedule = GetDrawSchedule(schedule);
+
+    minWall = MIN_WALL;
+    maxWall = MAX_WALL;
+
+    if (drawSchedule != nullptr)
+        drawSchedule->DrawRange(random, MIN_WALL, MAX_WALL, SCAN_MASS, minWall, maxWall);
+}
+
+// The wall counts are solved by numThread threads at once.  The smallest
+// match is the Product, which is the same Product a single thread would find.
+[[nodiscard]] static Product GenerateWallScan(const Filter& filter, Solver::Context& context,
+                                              Random& random, int numThread,
+                                              WallSchedule* schedule, KeySet* keySet)
+{
+    Square sqr;
+    if (!GenerateStartSquare(filter, random, sqr))
+        return Product(Product::Status::FAIL);
+
+    Scan scan(std::move(sqr), GenerateWallStack(random), context, numThread);
+
+    int minWall = 0;
+    int maxWall = 0;
+    DrawScanRange(random, schedule, minWall, maxWall);
+
+    (void)scan.Solve(filter, scan.GetWallCount(minWall, maxWall), schedule);
+    return scan.MakeProduct(keySet);
+}
+
+// Whether the wall counts between two probes are worth solving, which they
+// are when a probe is solvable at all, as a solvable Board seldom loses every
+// solution near the Filter depths within a few walls
+[[nodiscard]] static bool IsProbeSolvable(Solver::Solution::Status status)
+{
+    return status == Solver::Solution::Status::SOLVED ||
+           status == Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED;
+}
+
+// Every PROBE_STRIDE wall count is solved first, and then the counts between
+// two probes if one of them is solvable.  Every PROBE_AUDIT_INTERVAL attempt
+// is also scanned at every wall count from MIN_WALL to MAX_WALL, however the
+// WallSchedule has narrowed the probes, to tell how many matches are lost.
+// Only the probes and the counts between them are added to the WallSchedule.
+[[nodiscard]] static Product GenerateWallProbe(const Filter& filter, Solver::Context& context,
+                                               Random& random, int numThread,
+                                               WallSchedule* schedule, KeySet* keySet)
+{
+    Square sqr;
+    if (!GenerateStartSquare(filter, random, sqr))
+        return Product(Product::Status::FAIL);
+
+    Scan scan(std::move(sqr), GenerateWallStack(random), context, numThread);
+
+    int minWall = 0;
+    int maxWall = 0;
+    DrawScanRange(random, schedule, minWall, maxWall);
+
+    std::vector<int> wallCnt = scan.GetWallCount(minWall, maxWall);
+    std::vector<int> probeCnt;
+
+    for (size_t num = 0; num < wallCnt.size(); num += PROBE_STRIDE)
+        probeCnt.emplace_back(wallCnt.at(num));
+
+    if (!wallCnt.empty() && probeCnt.back() != wallCnt.back())
+        probeCnt.emplace_back(wallCnt.back());
+
+    std::vector<Solver::Solution::Status> probeStatus = scan.Solve(filter, probeCnt, schedule);
+    std::vector<int> gapCnt;
+
+    for (size_t num = 0; num + 1 < probeCnt.size(); num++) {
+
+        if (!IsProbeSolvable(probeStatus.at(num)) && !IsProbeSolvable(probeStatus.at(num + 1)))
             continue;
 
-        int filNum = filter.MatchFilter(brd, sqr, sol);
-        if (filNum >= 0) {
-            FillInconsequentialTiles(brd, sol);
-            FillUnreachableTiles(brd, sqr);
-            return Product(Product::Status::SUCCESS, filNum,
-                           std::move(brd), std::move(sqr),
-                           std::move(sol));
+        for (int cnt : wallCnt) {
+            if (cnt > probeCnt.at(num) && cnt < probeCnt.at(num + 1))
+                gapCnt.emplace_back(cnt);
         }
+    }
+
+    std::vector<Solver::Solution::Status> gapStatus = scan.Solve(filter, gapCnt, schedule);
+
+    long long numSolve = 0;
+    for (const auto& status : { probeStatus, gapStatus })
+        numSolve += std::count_if(status.begin(), status.end(), [](Solver::Solution::Status s) {
+            return s != Solver::Solution::Status::NONE;
+        });
+
+    bool isMatched = scan.GetMatchCount() <= MAX_WALL;
+    Product retProd = scan.MakeProduct(keySet);
+
+    if (_probeAttempt.fetch_add(1, std::memory_order_relaxed) % PROBE_AUDIT_INTERVAL != 0) {
+        auto lock = std::scoped_lock{ _probeMutex };
+        _probeStatistics.AddAttempt(numSolve);
+        return retProd;
+    }
+
+    scan.Reset();
+    (void)scan.Solve(filter, scan.GetWallCount(MIN_WALL, MAX_WALL), nullptr);
+    bool isAuditMatched = scan.GetMatchCount() <= MAX_WALL;
+
+    auto lock = std::scoped_lock{ _probeMutex };
+    _probeStatistics.AddAttempt(numSolve);
+    _probeStatistics.AddAudit(isAuditMatched, isAuditMatched && !isMatched);
+    return retProd;
+}
+
+// Every Square of a random Board is analyzed at once, so only the Squares
+// with a unique solution at one of the Filter depths are solved.  The
+// squares of each candidate are given a random order, as the analysis does
+// not tell squares apart.  The candidates share the Board, so they are solved
+// in batches.
+[[nodiscard]] static Product GenerateRetrograde(const Filter& filter, Solver::Context& context,
+                                                Random& random, Board brd, int numThread,
+                                                KeySet* keySet)
+{
+    Retrograde::Table& table = context.GetTable();
+    table.Build(brd, filter.GetMaxDepth(), numThread, &context.GetPool());
+
+    std::vector<uint64_t> candidate;
+
+    for (int depth = 1; depth <= filter.GetMaxDepth(); depth++) {
+        for (int entNum = 0; entNum < filter.GetNumEntry(); entNum++) {
+            if (filter.GetEntryDepth(entNum) != depth)
+                continue;
+
+            const std::vector<uint64_t>& mask = table.GetUniqueMask(depth);
+            candidate.insert(candidate.end(), mask.begin(), mask.end());
+            break;
+        }
+    }
+
+    // A start no Filter entry accepts is not worth a solve.  The Types of a
+    // Square do not depend on the order of its squares.
+    std::erase_if(candidate, [&](uint64_t mask) {
+        return !filter.MatchStart(Square::FromMask(mask));
+    });
+
+    for (int num = static_cast<int>(candidate.size()) - 1; num > 0; num--)
+        std::swap(candidate.at(num), candidate.at(random.GetInt(0, num)));
+
+    for (size_t begin = 0; begin < candidate.size(); begin += RETROGRADE_BATCH) {
+
+        size_t end = std::min(begin + RETROGRADE_BATCH, candidate.size());
+        std::vector<Square> sqr;
+        sqr.reserve(end - begin);
+
+        for (size_t can = begin; can < end; can++)
+            sqr.emplace_back(GenerateSquare(candidate.at(can), random));
+
+        std::vector<Solver::Solution> sol = Solver::Batch::Solve(brd, sqr, filter.GetMaxDepth(),
+                                                                  context.GetBatchWorkspace());
+
+        for (size_t num = 0; num < sqr.size(); num++) {
 
-        lastSol = std::move(sol);
+            if (sol.at(num).GetStatus() != Solver::Solution::Status::SOLVED)
+                continue;
+
+            int filNum = filter.MatchFilter(brd, sqr.at(num), sol.at(num));
+            if (filNum < 0)
+                continue;
+
+            return MakeMatchProduct(filNum, brd, std::move(sqr.at(num)),
+                                    std::move(sol.at(num)), context, numThread, keySet);
+        }
     }
 
     return Product(Product::Status::FAIL);
 }
 
+// Cell masks of the solved Squares on the Board which some Square slides
+// into.  A move only ends in a block whose squares are stacked against the
+// stops of the move, so most blocks in the open are left out.
+[[nodiscard]] static std::vector<uint64_t> GetReachableSolvedMask(const Board& board)
+{
+    static const uint64_t BLOCK = 0x3 | (0x3 << Board::NUM_COL);
+
+    std::vector<uint64_t> retMask;
+    std::vector<uint64_t> prev;
+
+    for (int r = 0; r < Board::NUM_ROW - 1; r++) {
+        for (int c = 0; c < Board::NUM_COL - 1; c++) {
+
+            uint64_t mask = BLOCK << Board::GetCell(Pos(r, c));
+            if (mask & board.GetWallMask())
+                continue;
+
+            prev.clear();
+
+            for (Movement::Dir dir = Movement::Dir::UP;
+                 dir <= Movement::Dir::RIGHT;
+                 dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1))
+                Movement::MoveReverse(board, mask, dir, prev);
+
+            if (!prev.empty())
+                retMask.emplace_back(mask);
+        }
+    }
+
+    return retMask;
+}
+
+// Whether a Square which slides into the last Square of a walk makes the walk
+// shorter than it looks, by being on the walk already or by sliding onto an
+// earlier Square of it or a solved Square
+[[nodiscard]] static bool IsShortcut(const Board& board, uint64_t mask,
+                                     const std::vector<uint64_t>& walk)
+{
+    if (std::find(walk.begin(), walk.end(), mask) != walk.end())
+        return true;
+
+    Movement::ResultAll moveRes = Movement::MoveAll(board, Square::FromMask(mask));
+
+    for (Movement::Dir dir = Movement::Dir::UP;
+         dir <= Movement::Dir::RIGHT;
+         dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+        if (!moveRes.IsSuccess(dir))
+            continue;
+
+        const Square newSquare = moveRes.GetSquare(dir);
+        uint64_t newMask = newSquare.GetMask();
+
+        if (newMask == walk.back())
+            continue;
+
+        if (newSquare.IsSolved() || std::find(walk.begin(), walk.end(), newMask) != walk.end())
+            return true;
+    }
+
+    return false;
+}
+
+// Walks back from solved Squares of a Board with inverse slide moves
+class ReverseWalk
+{
+public:
+
+    ReverseWalk(const Board& board, Random& random);
+    ReverseWalk(const ReverseWalk& walk) = delete;
+    ReverseWalk(ReverseWalk&& walk) = delete;
+
+    ~ReverseWalk() = default;
+
+    ReverseWalk& operator=(const ReverseWalk& walk) = delete;
+    ReverseWalk& operator=(ReverseWalk&& walk) = delete;
+
+    // Walk numMove moves back from a solved Square, each to a random Square
+    // which slides into the one before, is not a shortcut and fits the Types
+    // of the MatchProfile if there is one.  Returns the cell mask of the last
+    // Square, or 0 if no walk was found.
+    [[nodiscard]] uint64_t Walk(uint64_t solvedMask, int numMove, const Profiler::MatchProfile* profile);
+
+    // Whether the Square of the mask fits entry num of the MatchProfile.
+    // Anything fits without a MatchProfile.
+    [[nodiscard]] bool IsProfileMatched(uint64_t mask, const Profiler::MatchProfile* profile, int num);
+
+private:
+
+    const Board& _board;
+    Random& _random;
+
+    // Island Types of each Square met on the Board so far, as a Square is
+    // met many times over by the walks and working them out is the bulk of
+    // the cost of a walk
+    std::unordered_map<uint64_t, Profiler::TypeCount> _typeCount;
+
+    const Profiler::MatchProfile* _profile{ nullptr };
+    std::vector<uint64_t> _walk;
+    std::vector<std::unordered_set<uint64_t>> _dead;
+    int _numExpand{ 0 };
+
+    [[nodiscard]] bool Extend(int numMove);
+};
+
+ReverseWalk::ReverseWalk(const Board& board, Random& random) :
+    _board(board), _random(random)
+{
+}
+
+[[nodiscard]] uint64_t ReverseWalk::Walk(uint64_t solvedMask, int numMove,
+                                         const Profiler::MatchProfile* profile)
+{
+    // Precondition check
+    assert(numMove > 0);
+    assert(IsProfileMatched(solvedMask, profile, numMove));
+
+    _profile = profile;
+    _walk.clear();
+    _walk.emplace_back(solvedMask);
+    _dead.assign(numMove + 1, std::unordered_set<uint64_t>());
+    _numExpand = REVERSE_WALK_MAX_EXPAND;
+
+    if (!Extend(numMove))
+        return 0;
+
+    return _walk.back();
+}
+
+[[nodiscard]] bool ReverseWalk::IsProfileMatched(uint64_t mask, const Profiler::MatchProfile* profile,
+                                                 int num)
+{
+    if (profile == nullptr)
+        return true;
+
+    auto iter = _typeCount.find(mask);
+    if (iter == _typeCount.end())
+        iter = _typeCount.emplace(mask, Profiler::CountType(Square::FromMask(mask))).first;
+
+    return Profiler::MatchType(iter->second, *profile, num);
+}
+
+// Most Squares which slide into another are partway along the slide, and
+// nothing slides into them, so a walk which runs into one backs up and tries
+// another.  The walk gives up once REVERSE_WALK_MAX_EXPAND Squares have been
+// walked back from.
+//
+// A Square which could not be walked back from is not tried again at the same
+// place in the walk.  Whether a walk is a shortcut depends on the rest of it,
+// so this may pass over a few walks, but it keeps the search from going over
+// the same dead ends from every path which leads to them.
+[[nodiscard]] bool ReverseWalk::Extend(int numMove)
+{
+    if (numMove == 0)
+        return true;
+
+    if (_numExpand == 0 || _dead.at(numMove).contains(_walk.back()))
+        return false;
+
+    _numExpand--;
+
+    std::vector<uint64_t> prev;
+
+    for (Movement::Dir dir = Movement::Dir::UP;
+         dir <= Movement::Dir::RIGHT;
+         dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1))
+        Movement::MoveReverse(_board, _walk.back(), dir, prev);
+
+    // The Square before is entry numMove - 1 of the MatchProfile, as the
+    // solved Square is the last entry
+    std::erase_if(prev, [&](uint64_t mask) {
+        return !IsProfileMatched(mask, _profile, numMove - 1) || IsShortcut(_board, mask, _walk);
+    });
+
+    while (!prev.empty()) {
+
+        int num = _random.GetInt(0, static_cast<int>(prev.size()) - 1);
+        _walk.emplace_back(prev.at(num));
+
+        if (Extend(numMove - 1))
+            return true;
+
+        _walk.pop_back();
+        prev.at(num) = prev.back();
+        prev.pop_back();
+    }
+
+    if (_numExpand > 0)
+        _dead.at(numMove).insert(_walk.back());
+
+    return false;
+}
+
+// A MatchProfile compares a solution a Square at a time when it has an entry
+// for each Square of the solution and does not skip any.  A walk can then be
+// kept to its Types as it goes.
+[[nodiscard]] static const Profiler::MatchProfile* GetStepProfile(const Filter& filter, int num)
+{
+    const Profiler::MatchProfile* profile = filter.GetEntryProfile(num);
+
+    if (profile == nullptr || profile->GetNumEntry() != filter.GetEntryDepth(num) + 1)
+        return nullptr;
+
+    for (int entNum = 0; entNum < profile->GetNumEntry(); entNum++) {
+        if (profile->GetEntryMode(entNum) != Profiler::Mode::COMPARE)
+            return nullptr;
+    }
+
+    return profile;
+}
+
+// Walks back from solved Squares of a random Board by the depth of a random
+// Filter entry, keeping to the Types of its MatchProfile.  The walk is a
+// solution of that depth, so the solve only has to show that there is no other
+// solution as short.
+[[nodiscard]] static Product GenerateReverseWalk(const Filter& filter, Solver::Context& context,
+                                                 Random& random, Board brd, int numThread,
+                                                 KeySet* keySet)
+{
+    // A walk which fails has mostly tried every way back within its
+    // MatchProfile, so each Filter entry is walked back from each solved
+    // Square only once.
+    ReverseWalk walk(brd, random);
+    std::vector<std::pair<int, uint64_t>> start;
+
+    for (uint64_t solvedMask : GetReachableSolvedMask(brd)) {
+        for (int entNum = 0; entNum < filter.GetNumEntry(); entNum++) {
+            int depth = filter.GetEntryDepth(entNum);
+            if (walk.IsProfileMatched(solvedMask, GetStepProfile(filter, entNum), depth))
+                start.emplace_back(entNum, solvedMask);
+        }
+    }
+
+    for (int walkNum = 0; walkNum < REVERSE_WALK_PER_BOARD && !start.empty(); walkNum++) {
+
+        int startNum = random.GetInt(0, static_cast<int>(start.size()) - 1);
+        auto [entNum, solvedMask] = start.at(startNum);
+        start.at(startNum) = start.back();
+        start.pop_back();
+
+        int depth = filter.GetEntryDepth(entNum);
+
+        uint64_t mask = walk.Walk(solvedMask, depth, GetStepProfile(filter, entNum));
+        if (mask == 0)
+            continue;
+
+        Square sqr = GenerateSquare(mask, random);
+
+        Solver::Solution sol = Solver::Solve(brd, sqr, depth, context);
+        if (sol.GetStatus() != Solver::Solution::Status::SOLVED || sol.GetDepth() != depth)
+            continue;
+
+        int filNum = filter.MatchFilter(brd, sqr, sol);
+        if (filNum < 0)
+            continue;
+
+        return MakeMatchProduct(filNum, brd, std::move(sqr), std::move(sol),
+                                context, numThread, keySet);
+    }
+
+    return Product(Product::Status::FAIL);
+}
+
+[[nodiscard]] Product Generate(const Filter& filter, Solver::Context& context, Random& random,
+                                Mode mode, int numThread, WallSchedule* schedule,
+                                KeySet* keySet)
+{
+    // Precondition check
+    assert(filter.GetNumEntry() > 0);
+    assert(numThread > 0);
+
+    if (mode == Mode::WALL_PROBE)
+        return GenerateWallProbe(filter, context, random, numThread, schedule, keySet);
+
+    if (mode == Mode::WALL_SCAN)
+        return GenerateWallScan(filter, context, random, numThread, schedule, keySet);
+
+    // The rest try a single Board of a random wall count
+    int numWall = 0;
+    Board brd = GenerateBoard(random, schedule, numWall);
+
+    Product retProd = mode == Mode::RETROGRADE ?
+        GenerateRetrograde(filter, context, random, std::move(brd), numThread, keySet) :
+        GenerateReverseWalk(filter, context, random, std::move(brd), numThread, keySet);
+
+    if (schedule != nullptr) {
+        schedule->Add(numWall, retProd.GetStatus() == Product::Status::SUCCESS ?
+                               retProd.GetFilterNum() : -1);
+    }
+
+    return retProd;
+}
+
+[[nodiscard]] ProbeStatistics GetProbeStatistics()
+{
+    auto lock = std::scoped_lock{ _probeMutex };
+    return _probeStatistics;
+}
+
 } // namespace Generator
@@ -9,6 +9,10 @@
 
 #include "Filter.hpp"
 #include "Solver.hpp"
+#include "Context.hpp"
+#include "Random.hpp"
+#include "WallSchedule.hpp"
+#include "KeySet.hpp"
 #include "Board.hpp"
 #include "Square.hpp"
 
@@ -53,7 +57,83 @@ private:
     Solver::Solution _solution{ };
 };
 
-[[nodiscard]] Product Generate(const Filter& filter);
+enum class Mode : int
+{
+    // Add walls one at a time to a random Square, solving after each wall
+    WALL_SCAN = 0,
+    // Analyze every Square of a random Board at once, and only solve the
+    // Squares which have a unique solution at a depth the Filter wants
+    RETROGRADE,
+    // Add walls to a random Square like WALL_SCAN, but only solve every few
+    // wall counts at first, and then the counts near the solvable ones.  Far
+    // fewer solves are made, at the cost of a few matches, which
+    // GetProbeStatistics tells.
+    WALL_PROBE,
+    // Walk back from a solved Square on a random Board by exactly the depth
+    // of a Filter entry, and solve to check that the walk is the only
+    // shortest solution
+    REVERSE_WALK,
+};
+
+// Statistics of the WALL_PROBE attempts of every thread.  Some attempts are
+// audited, which is to also solve them at every wall count from MIN_WALL to
+// MAX_WALL.  An audited attempt is lost if only the audit matched the Filter,
+// whether the probes missed the match or the WallSchedule narrowed it away.
+class ProbeStatistics
+{
+public:
+
+    ProbeStatistics() = default;
+    ProbeStatistics(const ProbeStatistics& statistics) = default;
+    ProbeStatistics(ProbeStatistics&& statistics) noexcept = default;
+
+    ~ProbeStatistics() = default;
+
+    ProbeStatistics& operator=(const ProbeStatistics& statistics) = default;
+    ProbeStatistics& operator=(ProbeStatistics&& statistics) noexcept = default;
+
+    long long GetAttempt() const;
+    // Solves made by the attempts, less those of the audits
+    long long GetSolve() const;
+    long long GetAudit() const;
+    long long GetAuditMatch() const;
+    long long GetAuditLost() const;
+
+    void AddAttempt(long long numSolve);
+    void AddAudit(bool isMatched, bool isLost);
+
+private:
+
+    long long _attempt{ 0 };
+    long long _solve{ 0 };
+    long long _audit{ 0 };
+    long long _auditMatch{ 0 };
+    long long _auditLost{ 0 };
+};
+
+// The searches of the Product take their storage from the Context, which the
+// calling thread keeps from one Generate to the next.  Up to numThread threads
+// work on the Product, which is the same Product a single thread would make.
+// This cuts the time to each Product when there are more hardware threads
+// than Products made at once.  The Product only depends on the Filter, the
+// Mode and the state of the Random, which makes it reproducible from a seed.
+//
+// RETROGRADE and REVERSE_WALK try a single Board of a random wall count.  With
+// a WallSchedule, the count is drawn from it and what came of the Board is
+// added to it.  WALL_SCAN and WALL_PROBE then only solve the range of wall
+// counts drawn from it, and add each count they solve.  The Product so also
+// depends on what the WallSchedule has learned, unless it is not drawn from
+// and only learns.
+//
+// With a KeySet, a match which is a rotation or reflection of a puzzle in it
+// is dropped before it is filled, and the Product is FAIL.  The match is the
+// same with or without a KeySet, so the KeySet only saves the fill of a
+// puzzle which would be dropped as a duplicate anyway.
+[[nodiscard]] Product Generate(const Filter& filter, Solver::Context& context, Random& random,
+                               Mode mode = Mode::WALL_SCAN, int numThread = 1,
+                               WallSchedule* schedule = nullptr, KeySet* keySet = nullptr);
+
+[[nodiscard]] ProbeStatistics GetProbeStatistics();
 
 } // namespace Generator
 
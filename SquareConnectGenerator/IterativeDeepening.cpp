@@ -0,0 +1,264 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "IterativeDeepening.hpp"
+
+#include "Solver.hpp"
+#include "Util.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+#include "Pos.hpp"
+
+#include <bit>
+#include <array>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Solver
+{
+
+namespace IterativeDeepening
+{
+
+static const int NUM_BLOCK_ROW = Board::NUM_ROW - 1;
+static const int NUM_BLOCK_COL = Board::NUM_COL - 1;
+// Number of 2x2 blocks a solved Square can occupy
+static const int NUM_BLOCK = NUM_BLOCK_ROW * NUM_BLOCK_COL;
+
+static_assert(NUM_BLOCK <= 64, "Blocks must fit within a 64 bit mask");
+
+// Lower bounds up to this are told apart.  Anything further is bounded by it.
+static const int MAX_BOUND = 16;
+static const int INFINITE_BOUND = std::numeric_limits<int>::max();
+
+// Number of Squares remembered by each iteration.  Squares are stored by
+// hash and overwrite one another, so this only bounds the memory used.
+static const int TRANSPOSITION_BIT = 14;
+static const int NUM_TRANSPOSITION = 1 << TRANSPOSITION_BIT;
+
+// A square can be slid to any cell within reach of a move in the relaxed
+// problem, as if the other squares could always stop it short.  A move of
+// the real problem never takes a square further than that, so the number of
+// relaxed moves for the square furthest from a block is a lower bound.
+//
+// Bit b of _near[r][cell] is set if block b is within r relaxed moves of the
+// cell, where the last radius includes any block within reach at all.
+struct Heuristic
+{
+    std::array<std::array<uint64_t, Board::NUM_TILES>, MAX_BOUND + 1> _near{ };
+};
+
+// Square remembered by an iteration, with the number of solutions found
+// after it at that depth
+struct Transposition
+{
+    uint64_t _mask{ 0 };
+    int8_t _bound{ -1 };
+    int8_t _depth{ 0 };
+    int8_t _numPath{ 0 };
+};
+
+struct Search
+{
+    const Board& _board;
+    Heuristic _heuristic{ };
+
+    int _bound{ 0 };
+    int _nextBound{ INFINITE_BOUND };
+
+    std::vector<Movement::Dir> _dir{ };
+    std::vector<Square> _square{ };
+
+    std::vector<Movement::Dir> _solDir{ };
+    std::vector<Square> _solSquare{ };
+    int _numPath{ 0 };
+
+    std::vector<Transposition> _transposition{ };
+};
+
+[[nodiscard]] static Heuristic ComputeHeuristic(const Board& board)
+{
+    Heuristic retHeu;
+
+    uint64_t walls = board.GetWallMask();
+    uint64_t block = static_cast<uint64_t>(0x3) |
+                     (static_cast<uint64_t>(0x3) << Board::NUM_COL);
+
+    for (int b = 0; b < NUM_BLOCK; b++) {
+
+        uint64_t visited = block << Board::GetCell(Pos(b / NUM_BLOCK_COL, b % NUM_BLOCK_COL));
+        if (visited & walls)
+            continue;
+
+        uint64_t frontier = visited;
+        uint64_t bit = static_cast<uint64_t>(1) << b;
+
+        for (int dist = 0; frontier; dist++) {
+
+            for (uint64_t rest = frontier; rest; rest &= rest - 1)
+                retHeu._near[std::min(dist, MAX_BOUND)][std::countr_zero(rest)] |= bit;
+
+            frontier = Movement::GetMoveCells(board, frontier) & ~walls & ~visited;
+            visited |= frontier;
+        }
+    }
+
+    for (int r = 1; r <= MAX_BOUND; r++) {
+        for (int cell = 0; cell < Board::NUM_TILES; cell++)
+            retHeu._near[r][cell] |= retHeu._near[r - 1][cell];
+    }
+
+    return retHeu;
+}
+
+[[nodiscard]] static int GetLowerBound(const Heuristic& heuristic, const Square& square)
+{
+    const Square::Cells& cells = square.GetCells();
+
+    for (int r = 0; r <= MAX_BOUND; r++) {
+        const auto& near = heuristic._near[r];
+        if (near[cells[0]] & near[cells[1]] & near[cells[2]] & near[cells[3]])
+            return r;
+    }
+
+    return INFINITE_BOUND;
+}
+
+[[nodiscard]] static Transposition& GetTransposition(Search& search, uint64_t mask)
+{
+    uint64_t hash = mask * 0x9E3779B97F4A7C15;
+    return search._transposition.at(hash >> (64 - TRANSPOSITION_BIT));
+}
+
+// Count the solutions of depth _bound which follow a Square at a depth,
+// stopping as soon as there is more than one
+static int SearchDepth(Search& search, const Square& square, int depth)
+{
+    if (square.IsSolved()) {
+
+        // Invariant check
+        assert(depth == search._bound);
+
+        if (search._numPath == 0) {
+            search._solDir.assign(search._dir.begin(), search._dir.begin() + depth + 1);
+            search._solSquare.assign(search._square.begin(), search._square.begin() + depth + 1);
+        }
+
+        search._numPath++;
+        return 1;
+    }
+
+    int bound = GetLowerBound(search._heuristic, square);
+
+    if (bound == INFINITE_BOUND)
+        return 0;
+
+    if (depth + bound > search._bound) {
+        search._nextBound = std::min(search._nextBound, depth + bound);
+        return 0;
+    }
+
+    // A Square found again deeper than before cannot be on a shortest
+    // solution, and one found again at the same depth is followed by the
+    // same solutions.
+    uint64_t mask = square.GetMask();
+    Transposition& trans = GetTransposition(search, mask);
+
+    if (trans._mask == mask && trans._bound == search._bound) {
+        if (depth > trans._depth)
+            return 0;
+        if (depth == trans._depth) {
+            search._numPath += trans._numPath;
+            return trans._numPath;
+        }
+    }
+
+    int numPath = 0;
+    Movement::ResultAll moveRes = Movement::MoveAll(search._board, square);
+
+    for (Movement::Dir dir = Movement::Dir::UP;
+         dir <= Movement::Dir::RIGHT && search._numPath < MAX_NUM_PATH;
+         dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+        if (!moveRes.IsSuccess(dir))
+            continue;
+
+        const Square newSquare = moveRes.GetSquare(dir);
+
+        search._dir.at(depth + 1) = dir;
+        search._square.at(depth + 1) = newSquare;
+
+        numPath += SearchDepth(search, newSquare, depth + 1);
+    }
+
+    // The entry may have been taken by another Square in the meantime
+    Transposition& entry = GetTransposition(search, mask);
+    entry = Transposition{ mask, static_cast<int8_t>(search._bound), static_cast<int8_t>(depth),
+                           static_cast<int8_t>(std::min(numPath, MAX_NUM_PATH)) };
+
+    return numPath;
+}
+
+// Use Iterative Deepening A* to search for the shortest possible solution.
+// Each iteration is a Depth First Search which cuts off any Square whose
+// depth plus lower bound exceeds the bound of the iteration, and the bound is
+// raised to the smallest cut off until a solution is found.  Memory only
+// grows with the depth, plus a fixed table of Squares already searched.
+//
+// Every solution found by the last iteration is a shortest solution, so the
+// puzzle is solvable if that iteration finds exactly one.  A unique shortest
+// solution is also the one Solver::Solve returns.  Squares which cannot be
+// solved are recognized by the lower bound rather than by running out of
+// Squares, so UNSOLVABLE and MAX_DEPTH_REACHED may be swapped with respect to
+// Solver::Solve.
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth)
+{
+    // Precondition check
+    assert(Util::IsBoardSquareSane(board, square));
+    assert(!square.IsSolved());
+    assert(maxDepth > 0);
+
+    Search search{ board, ComputeHeuristic(board) };
+
+    search._bound = GetLowerBound(search._heuristic, square);
+
+    if (search._bound == INFINITE_BOUND)
+        return Solution(Solution::Status::UNSOLVABLE);
+
+    search._dir.resize(maxDepth + 1, Movement::Dir::NONE);
+    search._square.resize(maxDepth + 1);
+    search._square.at(0) = square;
+    search._transposition.resize(NUM_TRANSPOSITION);
+
+    while (search._bound <= maxDepth) {
+
+        search._nextBound = INFINITE_BOUND;
+        (void)SearchDepth(search, square, 0);
+
+        if (search._numPath >= MAX_NUM_PATH)
+            return Solution(Solution::Status::SHORTEST_SOLUTION_REPEATED);
+
+        if (search._numPath == 1) {
+            return Solution(Solution::Status::SOLVED, std::move(search._solDir),
+                            std::move(search._solSquare), search._bound);
+        }
+
+        if (search._nextBound == INFINITE_BOUND)
+            return Solution(Solution::Status::UNSOLVABLE);
+
+        search._bound = search._nextBound;
+    }
+
+    return Solution(Solution::Status::MAX_DEPTH_REACHED);
+}
+
+} // namespace IterativeDeepening
+
+} // namespace Solver
@@ -0,0 +1,249 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "KeySet.hpp"
+
+#include "Symmetry.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+#include "Pos.hpp"
+
+#include <filesystem>
+#include <system_error>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace Generator
+{
+
+// The file holds a header and a line for each Key, with its masks in hex:
+//
+//     KEY_SET <number of keys>
+//     KEY <walls> <squares>
+static const std::string FILE_HEADER = "KEY_SET";
+static const std::string FILE_KEY = "KEY";
+
+// Output writes each puzzle as a layout of one row per line, after a line
+// with this tag:
+//
+//     _layout = new sbyte[,]
+//     {
+//         { X, 0, A, ... },
+//         ...
+//     },
+//
+// where X is a wall, 0 is empty and A to D are the Squares.
+static const std::string LAYOUT_TAG = "_layout";
+
+bool KeySet::Claim(const Symmetry::Key& key)
+{
+    auto lock = std::scoped_lock{ _mutex };
+
+    if (_key.insert(key).second)
+        return true;
+
+    _duplicate++;
+    return false;
+}
+
+[[nodiscard]] size_t KeySet::GetSize() const
+{
+    auto lock = std::scoped_lock{ _mutex };
+    return _key.size();
+}
+
+[[nodiscard]] long long KeySet::GetDuplicate() const
+{
+    auto lock = std::scoped_lock{ _mutex };
+    return _duplicate;
+}
+
+bool KeySet::Load(const std::string& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs.is_open())
+        return false;
+
+    std::string line;
+    std::string tag;
+    size_t numKey = 0;
+
+    if (!std::getline(ifs, line) || !(std::istringstream(line) >> tag >> numKey) ||
+        tag != FILE_HEADER)
+        throw std::runtime_error("Reading key set header failed");
+
+    auto lock = std::scoped_lock{ _mutex };
+
+    _key.reserve(_key.size() + numKey);
+
+    while (std::getline(ifs, line)) {
+
+        std::istringstream iss(line);
+        if (!(iss >> tag))
+            continue;
+
+        uint64_t walls = 0;
+        uint64_t squares = 0;
+
+        if (tag != FILE_KEY || !(iss >> std::hex >> walls >> squares))
+            throw std::runtime_error("Reading key set key failed");
+
+        _key.insert(Symmetry::Key(walls, squares));
+    }
+
+    return true;
+}
+
+size_t KeySet::Import(const std::string& dir, int& numFail,
+                      std::map<std::string, int>& fileCount)
+{
+    numFail = 0;
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec))
+        return 0;
+
+    size_t numPuzzle = 0;
+    auto iter = std::filesystem::recursive_directory_iterator(dir, ec);
+
+    for (; !ec && iter != std::filesystem::recursive_directory_iterator(); iter.increment(ec)) {
+
+        if (!iter->is_regular_file(ec)) {
+            if (ec) {
+                numFail++;
+                ec.clear();
+            }
+            continue;
+        }
+
+        std::ifstream ifs(iter->path());
+        if (!ifs.is_open()) {
+            numFail++;
+            continue;
+        }
+
+        std::string fileName = iter->path().filename().string();
+        std::string line;
+
+        while (std::getline(ifs, line)) {
+
+            if (line.find(LAYOUT_TAG) == std::string::npos)
+                continue;
+
+            Board board;
+            Square square;
+
+            if (!ReadLayout(ifs, board, square))
+                continue;
+
+            // Puzzles read are not duplicates found by a Generator, so they
+            // are not claimed
+            Symmetry::Key key = Symmetry::GetCanonicalKey(board, square);
+
+            auto lock = std::scoped_lock{ _mutex };
+            _key.insert(key);
+            numPuzzle++;
+            fileCount[fileName]++;
+        }
+    }
+
+    // A directory which cannot be read ends the walk
+    if (ec)
+        numFail++;
+
+    return numPuzzle;
+}
+
+bool KeySet::ReadLayout(std::istream& is, Board& board, Square& square)
+{
+    std::vector<Board::Tile> tiles(Board::NUM_TILES, Board::Tile::EMPTY);
+    std::vector<Pos> pos(Square::NUM);
+    std::vector<bool> isSquare(Square::NUM, false);
+    std::string line;
+    int row = 0;
+
+    while (row < Board::NUM_ROW && std::getline(is, line)) {
+
+        int col = 0;
+
+        for (char c : line) {
+
+            if (c == ' ' || c == '\t' || c == '\r' || c == ',' || c == '{' || c == '}')
+                continue;
+
+            if (col >= Board::NUM_COL)
+                return false;
+
+            Pos tilePos(row, col);
+
+            if (c == 'X') {
+                tiles.at(Board::GetCell(tilePos)) = Board::Tile::WALL;
+            } else if (c >= 'A' && c < 'A' + Square::NUM) {
+                if (isSquare.at(c - 'A'))
+                    return false;
+                isSquare.at(c - 'A') = true;
+                pos.at(c - 'A') = tilePos;
+            } else if (c != '0') {
+                return false;
+            }
+
+            col++;
+        }
+
+        // The line which opens the layout has no tiles
+        if (col == 0)
+            continue;
+
+        if (col != Board::NUM_COL)
+            return false;
+
+        row++;
+    }
+
+    if (row != Board::NUM_ROW)
+        return false;
+
+    for (bool isFound : isSquare) {
+        if (!isFound)
+            return false;
+    }
+
+    board = Board(std::move(tiles));
+    square = Square(std::move(pos));
+    return true;
+}
+
+void KeySet::Save(const std::string& path) const
+{
+    std::string tempPath = path + ".tmp";
+
+    {
+        std::ofstream ofs(tempPath, std::ios_base::trunc);
+        if (!ofs.is_open())
+            throw std::runtime_error("Opening key set file failed");
+
+        auto lock = std::scoped_lock{ _mutex };
+
+        ofs << FILE_HEADER << " " << _key.size() << "\n" << std::hex;
+        for (const Symmetry::Key& key : _key)
+            ofs << FILE_KEY << " " << key.GetWalls() << " " << key.GetSquares() << "\n";
+
+        if (!ofs.flush())
+            throw std::runtime_error("Writing key set file failed");
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+} // namespace Generator
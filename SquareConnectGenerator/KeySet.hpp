@@ -0,0 +1,84 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef KEY_SET_HPP
+#define KEY_SET_HPP
+
+#include "Symmetry.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <istream>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include <string>
+#include <cstddef>
+
+namespace Generator
+{
+
+// Canonical Keys of the puzzles claimed so far, by this run and by the runs
+// whose keys or output files were read.  A Generator claims a match before it spends a fill
+// on it, so a puzzle found again, in any orientation, by any thread or in any
+// run, is dropped there.  Any number of threads may claim at once.
+class KeySet
+{
+public:
+
+    KeySet() = default;
+    KeySet(const KeySet& set) = delete;
+    KeySet(KeySet&& set) = delete;
+
+    ~KeySet() = default;
+
+    KeySet& operator=(const KeySet& set) = delete;
+    KeySet& operator=(KeySet&& set) = delete;
+
+    // Adds the Key.  Returns false, and counts a duplicate, if it was
+    // already there.
+    bool Claim(const Symmetry::Key& key);
+
+    [[nodiscard]] size_t GetSize() const;
+    // Claims which found their Key already there
+    [[nodiscard]] long long GetDuplicate() const;
+
+    // Adds the Keys of a file written by Save.  Returns false if there is no
+    // file, and throws if the file is not one.
+    bool Load(const std::string& path);
+
+    // Adds the Key of every puzzle in the files written by Output under dir
+    // and its subdirectories, so that puzzles written before there was a
+    // key set file are not generated again.  Layouts which are not of an 8x8
+    // Board are skipped, as are the files and directories which cannot be
+    // read, of which numFail is set to the number.  The puzzles read from
+    // the files of each name are added to fileCount, which are those of the
+    // Filter entry of that title.  Returns the number of puzzles read.
+    //
+    // The files only hold the filled puzzles, while a Generator claims the
+    // match before it is filled as well.  A match of an imported puzzle is
+    // so only dropped once it has been filled, unlike a match of a puzzle of
+    // a key set file.
+    size_t Import(const std::string& dir, int& numFail,
+                  std::map<std::string, int>& fileCount);
+
+    // Writes every Key to a file, by way of a temporary file so that a file
+    // is never left half written.  Throws on failure.
+    void Save(const std::string& path) const;
+
+private:
+
+    mutable std::mutex _mutex;
+    std::unordered_set<Symmetry::Key, Symmetry::KeyHash> _key{ };
+    long long _duplicate{ 0 };
+
+    // Reads the rows of the layout which follow its tag
+    static bool ReadLayout(std::istream& is, Board& board, Square& square);
+};
+
+} // namespace Generator
+
+#endif // KEY_SET_HPP
@@ -7,23 +7,30 @@
 #include "Util.hpp"
 #include "Output.hpp"
 #include "Generator.hpp"
+#include "Random.hpp"
+#include "WallSchedule.hpp"
+#include "KeySet.hpp"
+#include "ProductQueue.hpp"
 #include "UserFilter.hpp"
 #include "Filter.hpp"
 #include "Profiler.hpp"
 #include "Solver.hpp"
+#include "Context.hpp"
 #include "Movement.hpp"
 #include "Board.hpp"
 #include "Square.hpp"
 #include "Pos.hpp"
 
-#include <mutex>
 #include <thread>
 #include <atomic>
 #include <chrono>
-#include <stack>
 #include <map>
+#include <algorithm>
+#include <random>
+#include <cstdint>
 #include <chrono>
 #include <string>
+#include <exception>
 #include <iostream>
 #include <csignal>
 
@@ -35,31 +42,76 @@ void signalHandler(int signum)
     _exitFlag.store(true);
 }
 
-static std::mutex _mutex;
-static std::stack<Generator::Product> _product;
-
-static void generatePuzzles(const Filter& filter)
+static Generator::ProductQueue _product;
+
+// Attempts are numbered across every Generator Thread, and each attempt draws
+// from its own stream of the seed.  On a run which does not carry on from
+// earlier runs, an attempt so makes the same match from the same seed however
+// many threads there are, and the KeySet only fails the matches which Output
+// would drop as duplicates.  Which attempts finish before the run is stopped,
+// and the order their puzzles are written in, still depend on the threads.
+// A run which carries on also draws from the WallSchedule, which the other
+// threads change as they go, so it is not reproducible.
+static std::atomic<uint64_t> _attempt{ 0 };
+
+static void generatePuzzles(const Filter& filter, Generator::Mode mode, int numPuzzleThread,
+                            uint64_t seed, Generator::WallSchedule* schedule,
+                            Generator::KeySet* keySet)
 {
+    Solver::Context context;
+
     while (!_exitFlag.load()) {
 
-        Generator::Product prod = Generator::Generate(filter);
+        uint64_t attempt = _attempt.fetch_add(1, std::memory_order_relaxed);
+        Random random(Random::GetStreamSeed(seed, attempt));
+
+        Generator::Product prod = Generator::Generate(filter, context, random, mode,
+                                                      numPuzzleThread, schedule, keySet);
 
         if (prod.GetStatus() != Generator::Product::Status::SUCCESS)
             continue;
 
-        auto lock = std::scoped_lock{ _mutex };
-        _product.push(prod);
+        if (!_product.Push(std::move(prod)))
+            break;
     }
 }
 
+// The wall counts which match are learned by each mode, and kept from run to
+// run in a file of that mode, which is written this often.  Every run adds
+// to it, whether it carries on or not.
+static const std::string WALL_SCHEDULE_PATH = "output/WallSchedule";
+static const std::chrono::seconds WALL_SCHEDULE_SAVE_INTERVAL{ 60 };
+
+// The puzzles claimed by every mode are kept from run to run in a single
+// file, so a puzzle written by an earlier run is not generated again.  It is
+// written along with the WallSchedule.  The puzzles of the output files are
+// added to it as well, which covers the runs from before there was a file.
+static const std::string KEY_SET_PATH = "output/KeySet.txt";
+static const std::string OUTPUT_PATH = "output";
+
 static std::chrono::time_point<std::chrono::steady_clock> _startTime;
 
+// Each entry is wanted until it has as many puzzles as the entry with the
+// most, so the WallSchedule draws toward the entries which are behind
+static void updateQuota(const Filter& filter, const std::map<std::string, int>& quotaCount,
+                        Generator::WallSchedule& schedule)
+{
+    int maxCnt = 0;
+    for (const auto& qc : quotaCount)
+        maxCnt = std::max(maxCnt, qc.second);
+
+    for (int num = 0; num < filter.GetNumEntry(); num++)
+        schedule.SetQuota(num, maxCnt - quotaCount.at(filter.GetEntryTitle(num)) + 1);
+}
+
 static void printClear()
 {
     std::cout << "\033c";
 }
 
-static void printStatus(int numThread, const std::map<std::string, int>& genCount)
+static void printStatus(int numThread, uint64_t seed,
+                        const std::map<std::string, int>& genCount,
+                        const Generator::KeySet& keySet)
 {
     auto currTime = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(currTime - _startTime).count();
@@ -73,10 +125,33 @@ static void printStatus(int numThread, const std::map<std::string, int>& genCoun
     std::cout << "############################################################" << std::endl;
     std::cout << "Elapsed Time: " << hour << "h " << min << "m " << sec << "s" << std::endl;
     std::cout << "Threads: " << numThread << std::endl;
+    std::cout << "Seed: " << seed << std::endl;
     std::cout << "############################################################" << std::endl;
     for (const auto& gc : genCount)
         std::cout << gc.first << ": " << gc.second << std::endl;
     std::cout << "############################################################" << std::endl;
+    std::cout << "Puzzles Claimed: " << keySet.GetSize() << ", Duplicates Dropped: " <<
+                 keySet.GetDuplicate() << std::endl;
+    std::cout << "############################################################" << std::endl;
+
+    Solver::CacheStatistics cache = Solver::GetCacheStatistics();
+    long long lookup = cache.GetHit() + cache.GetMiss();
+
+    std::cout << "Solver Cache Hit Rate: " <<
+                 (lookup > 0 ? 100.0 * cache.GetHit() / lookup : 0.0) << "%, Hits: " <<
+                 cache.GetHit() << ", Misses: " << cache.GetMiss() << ", Evictions: " <<
+                 cache.GetEviction() << std::endl;
+    std::cout << "############################################################" << std::endl;
+
+    Generator::ProbeStatistics probe = Generator::GetProbeStatistics();
+    if (probe.GetAttempt() == 0)
+        return;
+
+    std::cout << "Probe Solves Per Attempt: " <<
+                 static_cast<double>(probe.GetSolve()) / probe.GetAttempt() << std::endl;
+    std::cout << "Probe Audits: " << probe.GetAudit() << ", Matched: " << probe.GetAuditMatch() <<
+                 ", Lost: " << probe.GetAuditLost() << std::endl;
+    std::cout << "############################################################" << std::endl;
 }
 
 int main()
@@ -104,6 +179,75 @@ int main()
         break;
     }
 
+    // Get generator mode
+
+    int mode{ 0 };
+
+    while (!_exitFlag.load()) {
+
+        std::cout << "Enter generator mode (0 = wall scan, 1 = retrograde, 2 = wall probe, " <<
+                     "3 = reverse walk):" << std::endl;
+        std::cin >> mode;
+
+        if (!std::cin || mode < static_cast<int>(Generator::Mode::WALL_SCAN) ||
+            mode > static_cast<int>(Generator::Mode::REVERSE_WALK)) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Invalid input" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    // Get seed
+
+    uint64_t seed{ 0 };
+
+    while (!_exitFlag.load()) {
+
+        std::cout << "Enter seed (0 = random):" << std::endl;
+        std::cin >> seed;
+
+        if (!std::cin) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Invalid input" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    if (seed == 0) {
+        std::random_device device;
+        seed = (static_cast<uint64_t>(device()) << 32) | device();
+    }
+
+    // Get whether to carry on from earlier runs.  If so, the puzzles they
+    // wrote are not generated again, and the wall counts they learned are
+    // drawn from.  If not, the Generators do not draw from the WallSchedule,
+    // whose contents change with the timing of the threads, so that the same
+    // seed makes the same puzzles.  They still add to it, and it is still
+    // written.  The key set file of the earlier runs is then left as it is.
+
+    int isResume{ 0 };
+
+    while (!_exitFlag.load()) {
+
+        std::cout << "Carry on from earlier runs (0 = no, 1 = yes):" << std::endl;
+        std::cin >> isResume;
+
+        if (!std::cin || isResume < 0 || isResume > 1) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Invalid input" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
     // Initialize common classes
 
     Output output;
@@ -112,57 +256,141 @@ int main()
 
     UserFilter::AddEntries(filter);
 
+    // Every mode draws its wall counts from the WallSchedule on a run which
+    // carries on, and learns them on every run
+
+    Generator::WallSchedule schedule(filterCRef, isResume != 0);
+    std::string schedulePath = WALL_SCHEDULE_PATH + std::to_string(mode) + ".txt";
+
+    // A file which cannot be read is replaced when the schedule is saved
+    try {
+        if (schedule.Load(schedulePath))
+            std::cout << "Loaded " << schedulePath << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Reading " << schedulePath << " failed (" << e.what() <<
+                     "), so the wall counts are learned again" << std::endl;
+    }
+
+    // Puzzles found again, by any thread, or any run on a run which carries
+    // on, are dropped before they are filled
+
+    Generator::KeySet keySet;
+
+    // Puzzles of the output files of each name, which is the title of the
+    // Filter entry they are of
+    std::map<std::string, int> fileCount;
+
+    if (isResume) {
+
+        if (keySet.Load(KEY_SET_PATH))
+            std::cout << "Loaded " << KEY_SET_PATH << std::endl;
+
+        int numFail = 0;
+        size_t numPuzzle = keySet.Import(OUTPUT_PATH, numFail, fileCount);
+
+        std::cout << "Imported " << numPuzzle << " puzzles from " << OUTPUT_PATH << std::endl;
+        if (numFail > 0)
+            std::cout << "Reading " << numFail << " files of " << OUTPUT_PATH << " failed" <<
+                         std::endl;
+    }
+
     // This is used to track the number of puzzles generated for each Filter entry
     std::map<std::string, int> genCount;
     for (int num = 0; num < filterCRef.GetNumEntry(); num++)
         genCount.insert(std::pair<std::string, int>(filterCRef.GetEntryTitle(num), 0));
 
-    // Spawn Generator Threads
+    // The quotas also count the puzzles of each Filter entry which the
+    // earlier runs wrote, on a run which carries on
+    std::map<std::string, int> quotaCount = genCount;
+    for (auto& qc : quotaCount) {
+        auto fcIter = fileCount.find(qc.first);
+        if (fcIter != fileCount.end())
+            qc.second += fcIter->second;
+    }
+
+    updateQuota(filterCRef, quotaCount, schedule);
+
+    // Spawn Generator Threads.  The hardware threads left over are shared out
+    // among them, so each puzzle is generated sooner when there are few
+    // Generator Threads.
+
+    int numHardwareThread = static_cast<int>(std::thread::hardware_concurrency());
+    int numPuzzleThread = std::max(numHardwareThread / numThread, 1);
 
     std::vector<std::thread> thread;
     thread.reserve(numThread);
     for (int num = 0; num < numThread; num++)
-        thread.emplace_back(std::thread(generatePuzzles, std::cref(filterCRef)));
+        thread.emplace_back(std::thread(generatePuzzles, std::cref(filterCRef),
+                                        static_cast<Generator::Mode>(mode), numPuzzleThread,
+                                        seed, &schedule, &keySet));
 
     // Process generated puzzles from Generator Threads
 
     _startTime = std::chrono::steady_clock::now();
 
+    // Products are written as soon as they arrive, and the status is printed
+    // once a second in between
+    auto statusTime = _startTime;
+    auto scheduleTime = _startTime + WALL_SCHEDULE_SAVE_INTERVAL;
+
     while (!_exitFlag.load()) {
 
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        auto currTime = std::chrono::steady_clock::now();
 
-        auto lock = std::scoped_lock{ _mutex };
+        if (currTime >= statusTime) {
+            printStatus(numThread, seed, genCount, keySet);
+            statusTime += std::chrono::seconds(1);
+            continue;
+        }
 
-        while (!_product.empty()) {
+        if (currTime >= scheduleTime) {
+            schedule.Save(schedulePath);
+            if (isResume)
+                keySet.Save(KEY_SET_PATH);
+            scheduleTime += WALL_SCHEDULE_SAVE_INTERVAL;
+        }
 
-            const Generator::Product& prod = _product.top();
+        Generator::Product prod;
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(statusTime - currTime);
 
-            int filNum = prod.GetFilterNum();
-            const Board& brd = prod.GetBoard();
-            const Square& sqr = prod.GetSquare();
-            const Solver::Solution& sol = prod.GetSolution();
+        if (!_product.Pop(prod, timeout))
+            continue;
 
-            auto gcIter = genCount.find(filterCRef.GetEntryTitle(filNum));
-            assert(gcIter != genCount.end());
-            gcIter->second++;
+        int filNum = prod.GetFilterNum();
+        const Board& brd = prod.GetBoard();
+        const Square& sqr = prod.GetSquare();
+        const Solver::Solution& sol = prod.GetSolution();
 
-            int cnt = gcIter->second;
-            std::string subDir = std::string("Depth_") + std::to_string(sol.GetDepth());
-            std::string fileName = filterCRef.GetEntryTitle(filNum);
+        auto gcIter = genCount.find(filterCRef.GetEntryTitle(filNum));
+        assert(gcIter != genCount.end());
 
-            output.AppendToFile(subDir, fileName, cnt, brd, sqr, sol);
-            _product.pop();
-        }
+        int cnt = gcIter->second + 1;
+        std::string subDir = std::string("Depth_") + std::to_string(sol.GetDepth());
+        std::string fileName = filterCRef.GetEntryTitle(filNum);
 
-        printStatus(numThread, genCount);
+        // Rotations and reflections of a puzzle already written are dropped.
+        // The Generator Threads have dropped them before filling already, so
+        // this is only a last check.
+        if (output.AppendToFile(subDir, fileName, cnt, brd, sqr, sol)) {
+            gcIter->second++;
+            quotaCount.at(gcIter->first)++;
+            updateQuota(filterCRef, quotaCount, schedule);
+        }
     }
 
+    // Close the queue, which fails the Products the threads have yet to push
+
+    _product.Close();
+
     // Wait for threads to exit
 
     for (int num = 0; num < numThread; num++)
         thread.at(num).join();
 
+    schedule.Save(schedulePath);
+    if (isResume)
+        keySet.Save(KEY_SET_PATH);
+
     std::cout << "Program exited" << std::endl;
     exit(0);
     return 0;
@@ -10,90 +10,357 @@
 #include "Board.hpp"
 #include "Square.hpp"
 #include "Pos.hpp"
+#include "Bits.hpp"
+#include "BoardSize.hpp"
 
+#include <bit>
+#include <array>
+#include <vector>
+#include <cstdint>
 #include <cassert>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOVEMENT_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace Movement
 {
 
-Result::Result(bool success, Square square) :
+template <int ROW, int COL>
+BasicResult<ROW, COL>::BasicResult(bool success, SquareType square) :
     _success(success),
     _square(std::move(square))
 {
 }
 
-bool Result::IsSuccess() const
+template <int ROW, int COL>
+bool BasicResult<ROW, COL>::IsSuccess() const
 {
     return _success;
 }
 
-const Square& Result::GetSquare() const
+template <int ROW, int COL>
+const typename BasicResult<ROW, COL>::SquareType& BasicResult<ROW, COL>::GetSquare() const
 {
     return _square;
 }
 
-[[nodiscard]] Result Move(const Board& board, const Square& square, Dir dir)
+template <int ROW, int COL>
+BasicResultAll<ROW, COL>::BasicResultAll(int successMask,
+                                         const std::array<Cells, NUM_DIR>& cells) :
+    _successMask(successMask),
+    _cells(cells)
+{
+}
+
+template <int ROW, int COL>
+int BasicResultAll<ROW, COL>::GetSuccessMask() const
+{
+    return _successMask;
+}
+
+template <int ROW, int COL>
+bool BasicResultAll<ROW, COL>::IsSuccess(Dir dir) const
+{
+    // Precondition check
+    assert(dir != Dir::NONE);
+
+    return (_successMask >> (static_cast<int>(dir) - 1)) & 1;
+}
+
+template <int ROW, int COL>
+typename BasicResultAll<ROW, COL>::SquareType BasicResultAll<ROW, COL>::GetSquare(Dir dir) const
+{
+    // Precondition check
+    assert(dir != Dir::NONE);
+
+    return SquareType(_cells[static_cast<int>(dir) - 1]);
+}
+
+static_assert(NUM_DIR == Board::NUM_SLIDE, "Movement::Dir must match Board slides");
+
+// Masks of every cell beyond a given cell, in a given direction, up to the
+// edge of the board.  Indexed by [Dir - 1][cell].
+template <int ROW, int COL>
+static constexpr auto RAY = []() {
+
+    using Mask = typename BasicBoard<ROW, COL>::Mask;
+
+    std::array<std::array<Mask, ROW * COL>, NUM_DIR> ray{ };
+
+    for (int cell = 0; cell < ROW * COL; cell++) {
+
+        int row = cell / COL;
+        int col = cell % COL;
+
+        for (int r = row - 1; r >= 0; r--)
+            ray[0][cell] |= Bits::GetBit<Mask>(r * COL + col);
+        for (int r = row + 1; r < ROW; r++)
+            ray[1][cell] |= Bits::GetBit<Mask>(r * COL + col);
+        for (int c = col - 1; c >= 0; c--)
+            ray[2][cell] |= Bits::GetBit<Mask>(row * COL + c);
+        for (int c = col + 1; c < COL; c++)
+            ray[3][cell] |= Bits::GetBit<Mask>(row * COL + c);
+    }
+
+    return ray;
+}();
+
+// Cell delta of a single step.  Indexed by [Dir - 1].
+template <int COL>
+static constexpr std::array<int, NUM_DIR> STEP{ -COL, COL, -1, 1 };
+
+// Each square slides to the stop given by the Board, and the squares that
+// share its path stack up against that stop.  The path is the part of the
+// ray up to the stop, so the final cell is the stop pulled back by the number
+// of squares on the path.
+template <int ROW, int COL>
+[[nodiscard]] BasicResult<ROW, COL> Move(const BasicBoard<ROW, COL>& board,
+                                         const BasicSquare<ROW, COL>& square, Dir dir)
 {
+    using BoardType = BasicBoard<ROW, COL>;
+    using SquareType = BasicSquare<ROW, COL>;
+    using Mask = typename BoardType::Mask;
+
     // Precondition check
     assert(dir != Dir::NONE);
     assert(Util::IsSquareWithinBoard(square));
 
-    // Calculate new position
+    const int d = static_cast<int>(dir) - 1;
+    const typename BoardType::Stops& stops = board.GetStops(d);
+    const Mask squares = square.GetMask();
 
-    std::vector<Pos> vPos;
-    vPos.reserve(Square::NUM);
+    typename SquareType::Cells cells = square.GetCells();
 
-    for (int num = 0; num < Square::NUM; num++) {
+    for (int num = 0; num < SquareType::NUM; num++) {
 
-        Pos pos = square.GetPos(num);
-        int rowDelta = 0;
-        int colDelta = 0;
-        int iter = 0;
+        int cell = cells[num];
+        int stop = stops[cell];
+        Mask path = RAY<ROW, COL>[d][cell] & ~RAY<ROW, COL>[d][stop];
+        int numSquare = Bits::PopCount(path & squares);
 
-        if (dir == Dir::UP) {
-            rowDelta = -1;
-            iter = pos.GetRow();
-        }
-        else if (dir == Dir::DOWN) {
-            rowDelta = 1;
-            iter = Board::NUM_ROW - pos.GetRow() - 1;
+        cells[num] = static_cast<int8_t>(stop - STEP<COL>[d] * numSquare);
+    }
+
+    bool success = (cells != square.GetCells());
+
+    return BasicResult<ROW, COL>(success, SquareType(cells));
+}
+
+// Every square of every direction is handled as one of 16 lanes, ordered by
+// direction and then square.  The squares stacked up on the path of a square
+// are the other squares between its cell and its stop, which lie on the same
+// column for UP and DOWN.  A horizontal path never leaves its row, so the
+// column check is skipped for LEFT and RIGHT.
+template <int ROW, int COL>
+[[nodiscard]] BasicResultAll<ROW, COL> MoveAll(const BasicBoard<ROW, COL>& board,
+                                               const BasicSquare<ROW, COL>& square)
+{
+    using BoardType = BasicBoard<ROW, COL>;
+    using SquareType = BasicSquare<ROW, COL>;
+
+    // Precondition check
+    assert(Util::IsSquareWithinBoard(square));
+
+    static_assert(NUM_DIR * SquareType::NUM == 16, "Lanes must fill 128 bits");
+
+    const typename SquareType::Cells& cells = square.GetCells();
+
+    alignas(16) std::array<int8_t, NUM_DIR * SquareType::NUM> stop;
+    alignas(16) std::array<typename SquareType::Cells, NUM_DIR> next;
+
+    static_assert(sizeof(next) == 16, "Cells must pack into 128 bits");
+
+    for (int d = 0; d < NUM_DIR; d++) {
+        const typename BoardType::Stops& stops = board.GetStops(d);
+        for (int num = 0; num < SquareType::NUM; num++)
+            stop[d * SquareType::NUM + num] = stops[cells[num]];
+    }
+
+#ifdef MOVEMENT_SSE2
+
+    // Cells are compared unsigned, which holds as every Board has fewer than
+    // 128 tiles
+    const __m128i cell = _mm_set1_epi32(std::bit_cast<int32_t>(cells));
+    const __m128i stopVec = _mm_load_si128(reinterpret_cast<const __m128i*>(stop.data()));
+    const __m128i low = _mm_min_epu8(cell, stopVec);
+    const __m128i high = _mm_max_epu8(cell, stopVec);
+    // Lanes of LEFT and RIGHT
+    const __m128i rowLane = _mm_set_epi32(-1, -1, 0, 0);
+    const __m128i step = _mm_set_epi8(1, 1, 1, 1, -1, -1, -1, -1,
+                                      COL, COL, COL, COL, -COL, -COL, -COL, -COL);
+
+    // Column of each square, repeated for every direction
+    typename SquareType::Cells cols;
+    for (int num = 0; num < SquareType::NUM; num++)
+        cols[num] = static_cast<int8_t>(cells[num] % COL);
+
+    const __m128i col = _mm_set1_epi32(std::bit_cast<int32_t>(cols));
+
+    __m128i nextVec = stopVec;
+
+    for (int num = 0; num < SquareType::NUM; num++) {
+
+        const __m128i other = _mm_set1_epi8(cells[num]);
+
+        __m128i onPath = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(other, low), other),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(other, high), other));
+        onPath = _mm_andnot_si128(_mm_cmpeq_epi8(other, cell), onPath);
+
+        __m128i sameCol = _mm_cmpeq_epi8(_mm_set1_epi8(cols[num]), col);
+        onPath = _mm_and_si128(onPath, _mm_or_si128(sameCol, rowLane));
+
+        nextVec = _mm_sub_epi8(nextVec, _mm_and_si128(onPath, step));
+    }
+
+    _mm_store_si128(reinterpret_cast<__m128i*>(next.data()), nextVec);
+    int same = _mm_movemask_epi8(_mm_cmpeq_epi8(nextVec, cell));
+
+#else
+
+    const typename BoardType::Mask squares = square.GetMask();
+    int same = 0;
+
+    for (int d = 0; d < NUM_DIR; d++) {
+        for (int num = 0; num < SquareType::NUM; num++) {
+
+            int lane = d * SquareType::NUM + num;
+            typename BoardType::Mask path = RAY<ROW, COL>[d][cells[num]] &
+                                            ~RAY<ROW, COL>[d][stop[lane]];
+            int numSquare = Bits::PopCount(path & squares);
+
+            next[d][num] = static_cast<int8_t>(stop[lane] - STEP<COL>[d] * numSquare);
+
+            if (next[d][num] == cells[num])
+                same |= 1 << lane;
         }
-        else if (dir == Dir::LEFT) {
-            colDelta = -1;
-            iter = pos.GetCol();
+    }
+
+#endif
+
+    int successMask = 0;
+
+    for (int d = 0; d < NUM_DIR; d++) {
+        if (((same >> (d * SquareType::NUM)) & 0xF) != 0xF)
+            successMask |= 1 << d;
+    }
+
+    return BasicResultAll<ROW, COL>(successMask, next);
+}
+
+// A Square can only be the result of a move if every square is stacked up
+// against the stop of its segment, where a segment is a run of empty cells
+// between walls along the direction of the move.  Any placement of the same
+// number of squares within each segment slides into it.
+template <int ROW, int COL>
+void MoveReverse(const BasicBoard<ROW, COL>& board, typename BasicBoard<ROW, COL>::Mask mask,
+                 Dir dir, std::vector<typename BasicBoard<ROW, COL>::Mask>& prev)
+{
+    using BoardType = BasicBoard<ROW, COL>;
+    using Mask = typename BoardType::Mask;
+
+    static const int NUM = BasicSquare<ROW, COL>::NUM;
+
+    // Precondition check
+    assert(dir != Dir::NONE);
+    assert(Bits::PopCount(mask) == NUM);
+    assert(!(mask & board.GetWallMask()));
+
+    const int d = static_cast<int>(dir) - 1;
+    // UP and DOWN, as well as LEFT and RIGHT, are adjacent to one another
+    const int o = d ^ 1;
+    const typename BoardType::Stops& stops = board.GetStops(d);
+    const typename BoardType::Stops& backStops = board.GetStops(o);
+    const auto& ray = RAY<ROW, COL>[d];
+
+    std::array<Mask, NUM> segCells{ };
+    std::array<int, NUM> segNum{ };
+    int numSeg = 0;
+
+    Mask rest = mask;
+
+    while (rest) {
+
+        int stop = stops[Bits::CountrZero(rest)];
+        int back = backStops[stop];
+        Mask seg = (ray[back] & ~ray[stop]) | Bits::GetBit<Mask>(back);
+        int num = Bits::PopCount(mask & seg);
+
+        int last = stop - STEP<COL>[d] * (num - 1);
+        Mask stack = (ray[last] & ~ray[stop]) | Bits::GetBit<Mask>(last);
+
+        if ((mask & seg) != stack)
+            return;
+
+        segCells[numSeg] = seg;
+        segNum[numSeg] = num;
+        numSeg++;
+
+        rest &= ~seg;
+    }
+
+    auto place = [&](auto& self, int seg, Mask placed) -> void {
+
+        if (seg == numSeg) {
+            if (placed != mask)
+                prev.emplace_back(placed);
+            return;
         }
-        else if (dir == Dir::RIGHT) {
-            colDelta = 1;
-            iter = Board::NUM_ROW - pos.GetCol() - 1;
+
+        Mask cells = segCells[seg];
+
+        for (Mask sub = cells; sub; sub = (sub - Mask(1)) & cells) {
+            if (Bits::PopCount(sub) == segNum[seg])
+                self(self, seg + 1, placed | sub);
         }
+    };
+
+    place(place, 0, Mask(0));
+}
 
-        int numSquareToWall = 0;
+// A square depends on every cell of its path up to the stop, and on the wall
+// which makes it stop unless it stops at the edge of the board.
+template <int ROW, int COL>
+[[nodiscard]] typename BasicBoard<ROW, COL>::Mask
+GetMoveCells(const BasicBoard<ROW, COL>& board, typename BasicBoard<ROW, COL>::Mask mask)
+{
+    using BoardType = BasicBoard<ROW, COL>;
+    using Mask = typename BoardType::Mask;
 
-        for (int it = 0; it < iter; it++) {
+    Mask retMask{ 0 };
 
-            pos.IncRow(rowDelta);
-            pos.IncCol(colDelta);
+    for (int d = 0; d < NUM_DIR; d++) {
 
-            if (board.GetTile(pos) == Board::Tile::WALL) {
-                pos.IncRow(-1 * rowDelta);
-                pos.IncCol(-1 * colDelta);
-                break;
-            }
+        const typename BoardType::Stops& stops = board.GetStops(d);
+        const auto& ray = RAY<ROW, COL>[d];
 
-            if (square.IsPosSquare(pos) >= 0)
-                numSquareToWall++;
-        }
+        for (Mask rest = mask; rest; rest &= rest - Mask(1)) {
 
-        pos.IncRow(-1 * rowDelta * numSquareToWall);
-        pos.IncCol(-1 * colDelta * numSquareToWall);
-        vPos.emplace_back(pos);
-    }
+            int cell = Bits::CountrZero(rest);
+            int stop = stops[cell];
 
-    Square squareNew(std::move(vPos));
-    bool success = ((squareNew == square) ==
-                   Square::Equality::PERFECTLY_EQUAL ? false : true);
+            retMask |= ray[cell] & ~ray[stop];
+            if (ray[stop])
+                retMask |= Bits::GetBit<Mask>(stop + STEP<COL>[d]);
+        }
+    }
 
-    return Result(success, std::move(squareNew));
+    return retMask;
 }
 
+#define INSTANTIATE(ROW, COL) \
+    template class BasicResult<ROW, COL>; \
+    template class BasicResultAll<ROW, COL>; \
+    template BasicResult<ROW, COL> Move(const BasicBoard<ROW, COL>&, \
+                                        const BasicSquare<ROW, COL>&, Dir); \
+    template BasicResultAll<ROW, COL> MoveAll(const BasicBoard<ROW, COL>&, \
+                                              const BasicSquare<ROW, COL>&); \
+    template void MoveReverse(const BasicBoard<ROW, COL>&, BasicBoard<ROW, COL>::Mask, Dir, \
+                              std::vector<BasicBoard<ROW, COL>::Mask>&); \
+    template BasicBoard<ROW, COL>::Mask GetMoveCells(const BasicBoard<ROW, COL>&, \
+                                                     BasicBoard<ROW, COL>::Mask);
+BOARD_SIZE_LIST(INSTANTIATE)
+#undef INSTANTIATE
+
 } // namespace Movement
@@ -10,6 +10,10 @@
 #include "Board.hpp"
 #include "Square.hpp"
 
+#include <array>
+#include <vector>
+#include <cstdint>
+
 namespace Movement
 {
 
@@ -22,30 +26,95 @@ enum class Dir : int
     RIGHT
 };
 
-class Result
+static const int NUM_DIR = 4;
+
+// Result of a move of a BasicSquare.  Result is the Result of the 8x8 Board.
+template <int ROW, int COL>
+class BasicResult
 {
 public:
 
-    Result() = default;
-    Result(bool success, Square square);
-    Result(const Result& result) = default;
-    Result(Result&& result) noexcept = default;
+    using SquareType = BasicSquare<ROW, COL>;
+
+    BasicResult() = default;
+    BasicResult(bool success, SquareType square);
+    BasicResult(const BasicResult& result) = default;
+    BasicResult(BasicResult&& result) noexcept = default;
 
-    ~Result() = default;
+    ~BasicResult() = default;
 
-    Result& operator=(const Result& result) = default;
-    Result& operator=(Result&& result) noexcept = default;
+    BasicResult& operator=(const BasicResult& result) = default;
+    BasicResult& operator=(BasicResult&& result) noexcept = default;
 
     bool IsSuccess() const;
-    const Square& GetSquare() const;
+    const SquareType& GetSquare() const;
 
 private:
 
     bool _success{ false };
-    Square _square{ };
+    SquareType _square{ };
+};
+
+using Result = BasicResult<8, 8>;
+
+// Squares after a move in every direction, along with a mask whose bit
+// Dir - 1 is set if the move in that direction succeeded
+template <int ROW, int COL>
+class BasicResultAll
+{
+public:
+
+    using SquareType = BasicSquare<ROW, COL>;
+    using Cells = typename SquareType::Cells;
+
+    BasicResultAll() = default;
+    BasicResultAll(int successMask, const std::array<Cells, NUM_DIR>& cells);
+    BasicResultAll(const BasicResultAll& result) = default;
+    BasicResultAll(BasicResultAll&& result) noexcept = default;
+
+    ~BasicResultAll() = default;
+
+    BasicResultAll& operator=(const BasicResultAll& result) = default;
+    BasicResultAll& operator=(BasicResultAll&& result) noexcept = default;
+
+    int GetSuccessMask() const;
+    bool IsSuccess(Dir dir) const;
+    SquareType GetSquare(Dir dir) const;
+
+private:
+
+    // Cells rather than Squares, so that no Square is built for a direction
+    // the caller never looks at
+    int _successMask{ 0 };
+    std::array<Cells, NUM_DIR> _cells{ };
 };
 
-[[nodiscard]] Result Move(const Board& board, const Square& old, Dir dir);
+using ResultAll = BasicResultAll<8, 8>;
+
+// The moves below are instantiated for every size in BoardSize.hpp, and the
+// size is deduced from the Board.
+template <int ROW, int COL>
+[[nodiscard]] BasicResult<ROW, COL> Move(const BasicBoard<ROW, COL>& board,
+                                         const BasicSquare<ROW, COL>& old, Dir dir);
+
+// Same as a Move in each direction, UP to RIGHT, computed together
+template <int ROW, int COL>
+[[nodiscard]] BasicResultAll<ROW, COL> MoveAll(const BasicBoard<ROW, COL>& board,
+                                               const BasicSquare<ROW, COL>& square);
+
+// Append the cell mask of every Square which slides into the Square with the
+// cell mask given when moved in dir.  Squares are not told apart, and the
+// given Square itself is never appended as the move would not succeed.
+template <int ROW, int COL>
+void MoveReverse(const BasicBoard<ROW, COL>& board, typename BasicBoard<ROW, COL>::Mask mask,
+                 Dir dir, std::vector<typename BasicBoard<ROW, COL>::Mask>& prev);
+
+// Mask of every cell whose tile decides where a square on any of the cells in
+// the mask comes to rest in any direction.  Changing any other tile leaves the
+// result of every move of a Square on these cells as it is.
+template <int ROW, int COL>
+[[nodiscard]] typename BasicBoard<ROW, COL>::Mask
+GetMoveCells(const BasicBoard<ROW, COL>& board, typename BasicBoard<ROW, COL>::Mask mask);
 
 }; // namespace Movement
 
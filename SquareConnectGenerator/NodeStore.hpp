@@ -0,0 +1,323 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef NODE_STORE_HPP
+#define NODE_STORE_HPP
+
+#include "Solver.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+#include "Bits.hpp"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+// Nodes of the Breadth First Search of Solver::Solve.  The members are defined
+// here rather than in a source file, so that the search can inline them.
+
+namespace Solver
+{
+
+// Node of the Breadth First Search packed into 64 bits.  The Square is kept as
+// four 6 bit cells, or 7 bit cells above 64 tiles, along with flags, and the
+// previous node shares a word with the Movement::Dir that led from it.
+template <int ROW, int COL>
+class Node
+{
+public:
+
+    using SquareType = BasicSquare<ROW, COL>;
+    using Mask = typename BasicBoard<ROW, COL>::Mask;
+
+    static const int MAX_NODE = (1 << 30) - 1;
+
+    Node() = default;
+    Node(Movement::Dir dir, const SquareType& square, int prevNode = -1, int numPath = 1);
+    Node(const Node& node) = default;
+    Node(Node&& node) noexcept = default;
+    ~Node() = default;
+
+    Node& operator=(const Node& node) = default;
+    Node& operator=(Node&& node) noexcept = default;
+
+    Movement::Dir GetDir() const;
+    SquareType GetSquare() const;
+    Mask GetMask() const;
+    bool GetSolved() const;
+    int GetPrevNode() const;
+    int GetNumPath() const;
+    void AddNumPath(int numPath);
+
+private:
+
+    static const int CELL_BIT = BasicBoard<ROW, COL>::NUM_TILES <= 64 ? 6 : 7;
+    static const uint32_t CELL_MASK = (1 << CELL_BIT) - 1;
+    static const uint32_t SOLVED_FLAG = 1 << (SquareType::NUM * CELL_BIT);
+    static const uint32_t REPEATED_FLAG = SOLVED_FLAG << 1;
+
+    static const int DIR_BIT = 2;
+    static const uint32_t DIR_MASK = (1 << DIR_BIT) - 1;
+
+    // Cells of the Square, then the flags
+    uint32_t _state{ 0 };
+    // One more than the previous node, then the Movement::Dir less one
+    uint32_t _link{ 0 };
+};
+
+static_assert(sizeof(Node<8, 8>) == 8, "Node must be packed into 64 bits");
+
+template <int ROW, int COL>
+Node<ROW, COL>::Node(Movement::Dir dir, const SquareType& square, int prevNode, int numPath)
+{
+    // Precondition check
+    assert(prevNode >= -1 && prevNode < MAX_NODE);
+    assert((prevNode == -1) == (dir == Movement::Dir::NONE));
+    assert(numPath > 0);
+
+    for (int num = 0; num < SquareType::NUM; num++) {
+        assert(square.GetCell(num) >= 0);
+        _state |= static_cast<uint32_t>(square.GetCell(num)) << (num * CELL_BIT);
+    }
+
+    if (square.IsSolved())
+        _state |= SOLVED_FLAG;
+    if (numPath >= MAX_NUM_PATH)
+        _state |= REPEATED_FLAG;
+
+    _link = static_cast<uint32_t>(prevNode + 1) << DIR_BIT;
+    if (dir != Movement::Dir::NONE)
+        _link |= static_cast<uint32_t>(static_cast<int>(dir) - 1);
+}
+
+template <int ROW, int COL>
+Movement::Dir Node<ROW, COL>::GetDir() const
+{
+    if (GetPrevNode() == -1)
+        return Movement::Dir::NONE;
+
+    return static_cast<Movement::Dir>((_link & DIR_MASK) + 1);
+}
+
+template <int ROW, int COL>
+typename Node<ROW, COL>::SquareType Node<ROW, COL>::GetSquare() const
+{
+    typename SquareType::Cells cells;
+
+    for (int num = 0; num < SquareType::NUM; num++)
+        cells[num] = static_cast<int8_t>((_state >> (num * CELL_BIT)) & CELL_MASK);
+
+    return SquareType(cells);
+}
+
+template <int ROW, int COL>
+typename Node<ROW, COL>::Mask Node<ROW, COL>::GetMask() const
+{
+    Mask retMask{ 0 };
+
+    for (int num = 0; num < SquareType::NUM; num++)
+        retMask |= Bits::GetBit<Mask>((_state >> (num * CELL_BIT)) & CELL_MASK);
+
+    return retMask;
+}
+
+template <int ROW, int COL>
+bool Node<ROW, COL>::GetSolved() const
+{
+    return _state & SOLVED_FLAG;
+}
+
+template <int ROW, int COL>
+int Node<ROW, COL>::GetPrevNode() const
+{
+    return static_cast<int>(_link >> DIR_BIT) - 1;
+}
+
+template <int ROW, int COL>
+int Node<ROW, COL>::GetNumPath() const
+{
+    return (_state & REPEATED_FLAG) ? MAX_NUM_PATH : 1;
+}
+
+template <int ROW, int COL>
+void Node<ROW, COL>::AddNumPath(int numPath)
+{
+    // Precondition check
+    assert(numPath > 0);
+    (void)numPath;
+
+    // Any more paths saturate the count
+    _state |= REPEATED_FLAG;
+}
+
+// Nodes are allocated in chunks, which never move once allocated, and looked
+// up by the cell mask of their Square through an open addressing table of
+// node indices.  Squares which are SOMEWHAT_EQUAL share a cell mask, so only
+// the first one found is kept.  Both the chunks and the table count towards
+// the memory limit.
+template <int ROW, int COL>
+class NodeStore
+{
+public:
+
+    using NodeType = Node<ROW, COL>;
+    using Mask = typename BasicBoard<ROW, COL>::Mask;
+
+    NodeStore(size_t memoryLimit);
+    NodeStore(const NodeStore& store) = delete;
+    NodeStore(NodeStore&& store) noexcept = default;
+    ~NodeStore() = default;
+
+    NodeStore& operator=(const NodeStore& store) = delete;
+    NodeStore& operator=(NodeStore&& store) noexcept = default;
+
+    // Remove every node, but keep the chunks and the table allocated so that
+    // the next search does not allocate until it outgrows this one
+    void Reset(size_t memoryLimit);
+
+    int GetSize() const;
+    NodeType& At(int idx);
+
+    // Index of the node with the cell mask, or -1 if there is none
+    int Find(Mask mask) const;
+    // Returns false if the node would exceed the memory limit
+    [[nodiscard]] bool Add(const NodeType& node);
+
+private:
+
+    static const int CHUNK_BIT = 13;
+    static const int CHUNK_SIZE = 1 << CHUNK_BIT;
+    static const int MIN_SLOT_BIT = 10;
+    // Empty slots are 0, as each slot holds one more than the node index
+    static constexpr uint32_t EMPTY_SLOT = 0;
+
+    size_t _memoryLimit{ 0 };
+    int _size{ 0 };
+    std::vector<std::unique_ptr<NodeType[]>> _chunk{ };
+    int _slotBit{ MIN_SLOT_BIT };
+    std::vector<uint32_t> _slot{ };
+
+    size_t GetMemory(int numChunk, int slotBit) const;
+    size_t GetSlot(Mask mask) const;
+    void Grow();
+};
+
+template <int ROW, int COL>
+NodeStore<ROW, COL>::NodeStore(size_t memoryLimit) :
+    _memoryLimit(memoryLimit),
+    _slot(static_cast<size_t>(1) << MIN_SLOT_BIT, EMPTY_SLOT)
+{
+}
+
+template <int ROW, int COL>
+void NodeStore<ROW, COL>::Reset(size_t memoryLimit)
+{
+    _memoryLimit = memoryLimit;
+    _size = 0;
+    _slotBit = MIN_SLOT_BIT;
+    _slot.assign(static_cast<size_t>(1) << MIN_SLOT_BIT, EMPTY_SLOT);
+}
+
+template <int ROW, int COL>
+int NodeStore<ROW, COL>::GetSize() const
+{
+    return _size;
+}
+
+template <int ROW, int COL>
+typename NodeStore<ROW, COL>::NodeType& NodeStore<ROW, COL>::At(int idx)
+{
+    // Precondition check
+    assert(idx >= 0 && idx < _size);
+
+    return _chunk[idx >> CHUNK_BIT][idx & (CHUNK_SIZE - 1)];
+}
+
+template <int ROW, int COL>
+int NodeStore<ROW, COL>::Find(Mask mask) const
+{
+    for (size_t slot = GetSlot(mask); ; slot = (slot + 1) & (_slot.size() - 1)) {
+
+        uint32_t idx = _slot[slot];
+        if (idx == EMPTY_SLOT)
+            return -1;
+
+        const NodeType& node = _chunk[(idx - 1) >> CHUNK_BIT][(idx - 1) & (CHUNK_SIZE - 1)];
+        if (node.GetMask() == mask)
+            return static_cast<int>(idx - 1);
+    }
+}
+
+template <int ROW, int COL>
+[[nodiscard]] bool NodeStore<ROW, COL>::Add(const NodeType& node)
+{
+    // Precondition check
+    assert(Find(node.GetMask()) == -1);
+
+    if (_size == NodeType::MAX_NODE)
+        return false;
+
+    // Keep the table at most half full
+    bool grow = 2 * (static_cast<size_t>(_size) + 1) > _slot.size();
+    // Chunks in use once the node is added.  Chunks kept by Reset are used
+    // again before any more are allocated.
+    int numChunk = (_size >> CHUNK_BIT) + 1;
+
+    if (GetMemory(numChunk, grow ? _slotBit + 1 : _slotBit) > _memoryLimit)
+        return false;
+
+    if (numChunk > static_cast<int>(_chunk.size()))
+        _chunk.emplace_back(std::make_unique<NodeType[]>(CHUNK_SIZE));
+
+    _chunk[_size >> CHUNK_BIT][_size & (CHUNK_SIZE - 1)] = node;
+    _size++;
+
+    if (grow) {
+        Grow();
+    } else {
+        size_t slot = GetSlot(node.GetMask());
+        while (_slot[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & (_slot.size() - 1);
+        _slot[slot] = static_cast<uint32_t>(_size);
+    }
+
+    return true;
+}
+
+template <int ROW, int COL>
+size_t NodeStore<ROW, COL>::GetMemory(int numChunk, int slotBit) const
+{
+    return static_cast<size_t>(numChunk) * CHUNK_SIZE * sizeof(NodeType) +
+           (static_cast<size_t>(1) << slotBit) * sizeof(uint32_t);
+}
+
+template <int ROW, int COL>
+size_t NodeStore<ROW, COL>::GetSlot(Mask mask) const
+{
+    return static_cast<size_t>(Bits::GetHash(mask) >> (64 - _slotBit));
+}
+
+// Double the table and insert every node again
+template <int ROW, int COL>
+void NodeStore<ROW, COL>::Grow()
+{
+    _slotBit++;
+    _slot.assign(static_cast<size_t>(1) << _slotBit, EMPTY_SLOT);
+
+    for (int idx = 0; idx < _size; idx++) {
+        size_t slot = GetSlot(At(idx).GetMask());
+        while (_slot[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & (_slot.size() - 1);
+        _slot[slot] = static_cast<uint32_t>(idx + 1);
+    }
+}
+
+} // namespace Solver
+
+#endif // NODE_STORE_HPP
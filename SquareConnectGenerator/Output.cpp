@@ -6,35 +6,51 @@
 
 #include "Output.hpp"
 
+#include "Symmetry.hpp"
 #include "Solver.hpp"
 #include "Util.hpp"
 #include "Board.hpp"
 #include "Square.hpp"
+#include "BoardSize.hpp"
 
 #include <filesystem>
 #include <exception>
 #include <fstream>
 #include <string>
-#include <format>
+#include <type_traits>
+#include <sstream>
+#include <iomanip>
 #include <ctime>
 
-Output::Output()
+// Directory named after the time the run started, so that no run writes to
+// the files of another
+[[nodiscard]] static std::string getOutputDir()
 {
     time_t t;
     struct tm tm;
 
     time(&t);
+#ifdef _WIN32
     if (localtime_s(&tm, &t))
         throw std::runtime_error("Calling localtime_s failed");
+#else
+    if (localtime_r(&t, &tm) == nullptr)
+        throw std::runtime_error("Calling localtime_r failed");
+#endif
+
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "output/%Y.%m.%d__(%H.%M.%S)");
+    return oss.str();
+}
 
-    _outputDir = std::format("output/{:4}.{:02}.{:02}__({:02}.{:02}.{:02})",
-                             tm.tm_year + 1900,
-                             tm.tm_mon + 1,
-                             tm.tm_mday,
-                             tm.tm_hour,
-                             tm.tm_min,
-                             tm.tm_sec);
+Output::Output() :
+    Output(getOutputDir())
+{
+}
 
+Output::Output(const std::string& outputDir) :
+    _outputDir(outputDir)
+{
     try {
         if (!std::filesystem::create_directories(_outputDir))
             throw std::runtime_error("Creating output directory failed");
@@ -43,17 +59,25 @@ Output::Output()
     }
 }
 
-void Output::AppendToFile(const std::string& subDir, const std::string& fileName, int count,
-                          const Board& board, const Square& square,
-                          const Solver::Solution& solution) const
+template <int ROW, int COL>
+bool Output::AppendToFile(const std::string& subDir, const std::string& fileName, int count,
+                          const BasicBoard<ROW, COL>& board, const BasicSquare<ROW, COL>& square,
+                          const Solver::BasicSolution<ROW, COL>& solution)
 {
+    using BoardType = BasicBoard<ROW, COL>;
+
     // Precondition check
     assert(subDir.length() > 0);
     assert(fileName.length() > 0);
     assert(count >= 0);
-    assert(solution.GetStatus() == Solver::Solution::Status::SOLVED);
+    assert((solution.GetStatus() == Solver::BasicSolution<ROW, COL>::Status::SOLVED));
     assert(Util::IsBoardSquareSolutionSane(board, square, solution));
 
+    if constexpr (std::is_same_v<BoardType, Board>) {
+        if (!_written.insert(Symmetry::GetCanonicalKey(board, square)).second)
+            return false;
+    }
+
     std::string subDirPath = _outputDir + "/" + subDir;
     std::string filePath = subDirPath + "/" + fileName;
 
@@ -77,17 +101,17 @@ void Output::AppendToFile(const std::string& subDir, const std::string& fileName
     ofs << "\t\t\t\t_layout = new sbyte[,]" << std::endl;
     ofs << "\t\t\t\t{" << std::endl;
 
-    for (int row = 0; row < Board::NUM_ROW; row++)
+    for (int row = 0; row < BoardType::NUM_ROW; row++)
     {
         ofs << "\t\t\t\t\t{ ";
 
-        for (int col = 0; col < Board::NUM_COL; col++)
+        for (int col = 0; col < BoardType::NUM_COL; col++)
         {
             Pos pos(row, col);
-            Board::Tile tile = board.GetTile(pos);
+            typename BoardType::Tile tile = board.GetTile(pos);
             int sqrIdx;
 
-            if (tile == Board::Tile::WALL) {
+            if (tile == BoardType::Tile::WALL) {
                 ofs << "X, ";
                 continue;
             }
@@ -139,4 +163,13 @@ void Output::AppendToFile(const std::string& subDir, const std::string& fileName
     ofs << std::endl;
 
     ofs.close();
+
+    return true;
 }
+
+#define INSTANTIATE(ROW, COL) \
+    template bool Output::AppendToFile(const std::string&, const std::string&, int, \
+                                       const BasicBoard<ROW, COL>&, const BasicSquare<ROW, COL>&, \
+                                       const Solver::BasicSolution<ROW, COL>&);
+BOARD_SIZE_LIST(INSTANTIATE)
+#undef INSTANTIATE
@@ -7,17 +7,22 @@
 #ifndef OUTPUT_HPP
 #define OUTPUT_HPP
 
+#include "Symmetry.hpp"
 #include "Solver.hpp"
 #include "Board.hpp"
 #include "Square.hpp"
 
 #include <string>
+#include <unordered_set>
 
 class Output
 {
 public:
 
     Output();
+    // Writes under outputDir, which must not exist yet, rather than under a
+    // directory named after the time
+    Output(const std::string& outputDir);
     Output(const Output& output) = delete;
     Output(Output&& output) noexcept = delete;
 
@@ -26,13 +31,19 @@ public:
     Output& operator=(const Output& output) = delete;
     Output& operator=(Output&& output) noexcept = delete;
 
-    void AppendToFile(const std::string& subDir, const std::string& fileName, int count,
-                      const Board& board, const Square& square,
-                      const Solver::Solution& solution) const;
+    // Returns false, without writing anything, if the puzzle is a rotation or
+    // reflection of one already written.  Only puzzles on the 8x8 Board are
+    // told apart by symmetry, and puzzles of other sizes are always written.
+    template <int ROW, int COL>
+    bool AppendToFile(const std::string& subDir, const std::string& fileName, int count,
+                      const BasicBoard<ROW, COL>& board, const BasicSquare<ROW, COL>& square,
+                      const Solver::BasicSolution<ROW, COL>& solution);
 
 private:
 
     std::string _outputDir{ };
+    // Canonical Key of every puzzle written
+    std::unordered_set<Symmetry::Key, Symmetry::KeyHash> _written{ };
 };
 
 #endif // OUTPUT_HPP
@@ -0,0 +1,434 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Parallel.hpp"
+
+#include "Solver.hpp"
+#include "WorkerPool.hpp"
+#include "Util.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Solver
+{
+
+namespace Parallel
+{
+
+static const int MAX_NODE = (1 << 30) - 1;
+
+// Most nodes taken by a thread at a time
+static const int CHUNK_SIZE = 256;
+static const int MIN_SLOT_BIT = 10;
+
+// Squares are packed the same way as the nodes of Solver::Solve
+static const int CELL_BIT = 6;
+static const uint32_t CELL_MASK = (1 << CELL_BIT) - 1;
+static const uint32_t SOLVED_FLAG = 1 << (Square::NUM * CELL_BIT);
+static const uint32_t REPEATED_FLAG = SOLVED_FLAG << 1;
+
+static const int DIR_BIT = 2;
+static const uint32_t DIR_MASK = (1 << DIR_BIT) - 1;
+
+static const uint64_t EMPTY_MASK = 0;
+static const uint64_t NO_PARENT = std::numeric_limits<uint64_t>::max();
+
+static_assert(Board::NUM_TILES <= 64, "Parallel cells must fit within 6 bits");
+
+[[nodiscard]] static uint32_t GetState(const Square& square)
+{
+    uint32_t retState = 0;
+
+    for (int num = 0; num < Square::NUM; num++) {
+        assert(square.GetCell(num) >= 0);
+        retState |= static_cast<uint32_t>(square.GetCell(num)) << (num * CELL_BIT);
+    }
+
+    if (square.IsSolved())
+        retState |= SOLVED_FLAG;
+
+    return retState;
+}
+
+[[nodiscard]] static Square GetSquare(uint32_t state)
+{
+    Square::Cells cells;
+
+    for (int num = 0; num < Square::NUM; num++)
+        cells[num] = static_cast<int8_t>((state >> (num * CELL_BIT)) & CELL_MASK);
+
+    return Square(cells);
+}
+
+[[nodiscard]] static uint64_t GetMask(uint32_t state)
+{
+    uint64_t retMask = 0;
+
+    for (int num = 0; num < Square::NUM; num++)
+        retMask |= static_cast<uint64_t>(1) << ((state >> (num * CELL_BIT)) & CELL_MASK);
+
+    return retMask;
+}
+
+// Open addressing table from cell mask to node, which every thread inserts
+// into while a layer is expanded.  A Square first found in the layer being
+// expanded has no node until the layer is done, and only gathers its parents
+// until then.  The lowest parent is kept along with the Square it produced,
+// keyed by the parent node times 4 plus the Movement::Dir less one.  This is
+// the order in which Solver::Solve finds the Squares, so the lowest parent is
+// the one Solver::Solve links to, however the threads are scheduled.
+class Visited
+{
+public:
+
+    // Bytes taken by each slot
+    static const size_t SLOT_SIZE = sizeof(uint64_t) + sizeof(uint64_t) +
+                                    sizeof(uint32_t) + sizeof(int);
+
+    Visited() = default;
+    Visited(const Visited& visited) = delete;
+    Visited(Visited&& visited) noexcept = default;
+    ~Visited() = default;
+
+    Visited& operator=(const Visited& visited) = delete;
+    Visited& operator=(Visited&& visited) noexcept = default;
+
+    int GetSlotBit() const;
+    // Empty the table with 2 ^ slotBit slots
+    void Reset(int slotBit);
+
+    // Slot of the cell mask, along with whether it was inserted
+    std::pair<size_t, bool> Insert(uint64_t mask);
+
+    int GetNode(size_t slot) const;
+    void SetNode(size_t slot, int node);
+
+    // Lowest parent key in the upper 32 bits, and the Square it produced in
+    // the lower 32 bits
+    uint64_t GetParent(size_t slot) const;
+    void AddParent(size_t slot, uint32_t parentKey, uint32_t state, int numPath);
+    int GetNumPath(size_t slot) const;
+
+private:
+
+    int _slotBit{ 0 };
+    std::unique_ptr<std::atomic<uint64_t>[]> _mask{ };
+    std::unique_ptr<std::atomic<uint64_t>[]> _parent{ };
+    std::unique_ptr<std::atomic<uint32_t>[]> _numPath{ };
+    // Only written between layers
+    std::vector<int> _node{ };
+
+    size_t GetSlot(uint64_t mask) const;
+};
+
+int Visited::GetSlotBit() const
+{
+    return _slotBit;
+}
+
+void Visited::Reset(int slotBit)
+{
+    size_t numSlot = static_cast<size_t>(1) << slotBit;
+
+    _slotBit = slotBit;
+    _mask = std::make_unique<std::atomic<uint64_t>[]>(numSlot);
+    _parent = std::make_unique<std::atomic<uint64_t>[]>(numSlot);
+    _numPath = std::make_unique<std::atomic<uint32_t>[]>(numSlot);
+    _node.assign(numSlot, -1);
+
+    for (size_t slot = 0; slot < numSlot; slot++) {
+        _mask[slot].store(EMPTY_MASK, std::memory_order_relaxed);
+        _parent[slot].store(NO_PARENT, std::memory_order_relaxed);
+        _numPath[slot].store(0, std::memory_order_relaxed);
+    }
+}
+
+std::pair<size_t, bool> Visited::Insert(uint64_t mask)
+{
+    // Precondition check
+    assert(mask != EMPTY_MASK);
+
+    size_t numSlot = static_cast<size_t>(1) << _slotBit;
+
+    for (size_t slot = GetSlot(mask); ; slot = (slot + 1) & (numSlot - 1)) {
+
+        uint64_t curr = _mask[slot].load(std::memory_order_acquire);
+
+        if (curr == EMPTY_MASK &&
+            _mask[slot].compare_exchange_strong(curr, mask, std::memory_order_acq_rel))
+            return { slot, true };
+
+        // The slot may have just been taken by the same mask
+        if (curr == mask)
+            return { slot, false };
+    }
+}
+
+int Visited::GetNode(size_t slot) const
+{
+    return _node[slot];
+}
+
+void Visited::SetNode(size_t slot, int node)
+{
+    _node[slot] = node;
+}
+
+uint64_t Visited::GetParent(size_t slot) const
+{
+    return _parent[slot].load(std::memory_order_relaxed);
+}
+
+void Visited::AddParent(size_t slot, uint32_t parentKey, uint32_t state, int numPath)
+{
+    uint64_t parent = (static_cast<uint64_t>(parentKey) << 32) | state;
+    uint64_t curr = _parent[slot].load(std::memory_order_relaxed);
+
+    while (parent < curr &&
+           !_parent[slot].compare_exchange_weak(curr, parent, std::memory_order_relaxed)) {
+    }
+
+    _numPath[slot].fetch_add(static_cast<uint32_t>(numPath), std::memory_order_relaxed);
+}
+
+int Visited::GetNumPath(size_t slot) const
+{
+    return static_cast<int>(std::min(_numPath[slot].load(std::memory_order_relaxed),
+                                     static_cast<uint32_t>(MAX_NUM_PATH)));
+}
+
+size_t Visited::GetSlot(uint64_t mask) const
+{
+    return static_cast<size_t>((mask * 0x9E3779B97F4A7C15) >> (64 - _slotBit));
+}
+
+// What a thread found while expanding its part of a layer
+struct Worker
+{
+    // Slots of the Squares first found by this thread
+    std::vector<size_t> _created{ };
+    int _solNumPath{ 0 };
+    // Lowest parent key of a solved Square, and its slot
+    uint32_t _solKey{ std::numeric_limits<uint32_t>::max() };
+    size_t _solSlot{ 0 };
+};
+
+// Use a level synchronous Breadth First Search, which gives the same Solution
+// as Solver::Solve.  The nodes of each layer are split across threads, which
+// insert the Squares they find into a shared table.  Once the layer is done,
+// the new Squares are sorted by their lowest parent key, which is the order
+// Solver::Solve adds them in, and given their nodes.
+//
+// Every path into a Square of the new layer adds to its path count, as does
+// every path into a solved Square to the solution count, so the counts do not
+// depend on the order the paths are found in.  The table is made large enough
+// for every Square a layer could add before it is expanded, so the memory
+// limit may be reached somewhat sooner than by Solver::Solve.
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth,
+                             WorkerPool& pool, int numThread, size_t memoryLimit,
+                             int minParallelNode)
+{
+    // Precondition check
+    assert(Util::IsBoardSquareSane(board, square));
+    assert(!square.IsSolved());
+    assert(maxDepth > 0);
+    assert(numThread > 0);
+    assert(minParallelNode > 0);
+
+    // Square of each node, and its previous node plus one followed by the
+    // Movement::Dir less one
+    std::vector<uint32_t> state{ GetState(square) };
+    std::vector<uint32_t> link{ 0 };
+
+    Visited visited;
+    visited.Reset(MIN_SLOT_BIT);
+    visited.SetNode(visited.Insert(square.GetMask()).first, 0);
+
+    std::vector<Worker> worker(numThread);
+
+    int layerBegin = 0;
+    int layerEnd = 1;
+    int depth = 0;
+
+    while (true) {
+
+        if (layerBegin == layerEnd)
+            return Solution(Solution::Status::UNSOLVABLE);
+
+        if (depth + 1 > maxDepth)
+            return Solution(Solution::Status::MAX_DEPTH_REACHED);
+
+        // Make room for every Square the layer could add
+
+        long long maxNode = static_cast<long long>(layerEnd) +
+                            static_cast<long long>(Movement::NUM_DIR) * (layerEnd - layerBegin);
+        if (maxNode > MAX_NODE)
+            return Solution(Solution::Status::MEMORY_LIMIT_REACHED);
+
+        int slotBit = visited.GetSlotBit();
+        while ((static_cast<long long>(1) << slotBit) < 2 * maxNode)
+            slotBit++;
+
+        size_t memory = static_cast<size_t>(maxNode) * (sizeof(uint32_t) + sizeof(uint32_t)) +
+                        (static_cast<size_t>(1) << slotBit) * Visited::SLOT_SIZE;
+        if (memory > memoryLimit)
+            return Solution(Solution::Status::MEMORY_LIMIT_REACHED);
+
+        if (slotBit != visited.GetSlotBit()) {
+            visited.Reset(slotBit);
+            for (int idx = 0; idx < layerEnd; idx++)
+                visited.SetNode(visited.Insert(GetMask(state[idx])).first, idx);
+        }
+
+        // Expand the layer, a chunk at a time, on the threads of the pool.
+        // The Run returns once the whole layer is expanded, which keeps the
+        // layers apart.  Chunks are made small enough for every thread to
+        // have one.
+
+        int layerSize = layerEnd - layerBegin;
+        int numWorker = (layerSize < minParallelNode) ? 1 : numThread;
+        int chunkSize = std::min(CHUNK_SIZE, (layerSize + numWorker - 1) / numWorker);
+        int numChunk = (layerSize + chunkSize - 1) / chunkSize;
+
+        pool.Run(numChunk, numWorker, [&](int chunk, int workerNum) {
+
+            Worker& work = worker.at(workerNum);
+
+            int begin = layerBegin + chunk * chunkSize;
+            int end = std::min(begin + chunkSize, layerEnd);
+
+            for (int idx = begin; idx < end; idx++) {
+
+                if (state[idx] & SOLVED_FLAG)
+                    continue;
+
+                int numPath = (state[idx] & REPEATED_FLAG) ? MAX_NUM_PATH : 1;
+                Movement::ResultAll moveRes = Movement::MoveAll(board, GetSquare(state[idx]));
+
+                for (Movement::Dir dir = Movement::Dir::UP;
+                     dir <= Movement::Dir::RIGHT;
+                     dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
+
+                    if (!moveRes.IsSuccess(dir))
+                        continue;
+
+                    const Square newSquare = moveRes.GetSquare(dir);
+                    auto [slot, inserted] = visited.Insert(newSquare.GetMask());
+
+                    if (inserted)
+                        work._created.emplace_back(slot);
+
+                    // Paths through an earlier layer are not shortest paths
+                    if (visited.GetNode(slot) >= 0)
+                        continue;
+
+                    uint32_t parentKey = (static_cast<uint32_t>(idx) << DIR_BIT) |
+                                         static_cast<uint32_t>(static_cast<int>(dir) - 1);
+                    visited.AddParent(slot, parentKey, GetState(newSquare), numPath);
+
+                    if (newSquare.IsSolved()) {
+                        work._solNumPath += numPath;
+                        if (parentKey < work._solKey) {
+                            work._solKey = parentKey;
+                            work._solSlot = slot;
+                        }
+                    }
+                }
+            }
+        });
+
+        // Give the new Squares their nodes in the order Solver::Solve finds them
+
+        std::vector<size_t> created;
+        int solNumPath = 0;
+        uint32_t solKey = std::numeric_limits<uint32_t>::max();
+        size_t solSlot = 0;
+
+        for (Worker& work : worker) {
+
+            created.insert(created.end(), work._created.begin(), work._created.end());
+            solNumPath += work._solNumPath;
+
+            if (work._solKey < solKey) {
+                solKey = work._solKey;
+                solSlot = work._solSlot;
+            }
+
+            work = Worker();
+        }
+
+        std::sort(created.begin(), created.end(), [&visited](size_t a, size_t b) {
+            return visited.GetParent(a) < visited.GetParent(b);
+        });
+
+        for (size_t slot : created) {
+
+            uint64_t parent = visited.GetParent(slot);
+            uint32_t parentKey = static_cast<uint32_t>(parent >> 32);
+            uint32_t newState = static_cast<uint32_t>(parent);
+
+            if (visited.GetNumPath(slot) >= MAX_NUM_PATH)
+                newState |= REPEATED_FLAG;
+
+            visited.SetNode(slot, static_cast<int>(state.size()));
+            state.emplace_back(newState);
+            link.emplace_back((((parentKey >> DIR_BIT) + 1) << DIR_BIT) | (parentKey & DIR_MASK));
+        }
+
+        depth++;
+        layerBegin = layerEnd;
+        layerEnd = static_cast<int>(state.size());
+
+        if (solNumPath >= MAX_NUM_PATH)
+            return Solution(Solution::Status::SHORTEST_SOLUTION_REPEATED);
+
+        if (solNumPath == 0)
+            continue;
+
+        // Construct solution
+
+        std::vector<Movement::Dir> retDir;
+        retDir.reserve(depth + 1);
+
+        std::vector<Square> retSquare;
+        retSquare.reserve(depth + 1);
+
+        int prevNode = visited.GetNode(solSlot);
+
+        do {
+            // Invariant check
+            assert(!(state[prevNode] & REPEATED_FLAG));
+
+            int prev = static_cast<int>(link[prevNode] >> DIR_BIT) - 1;
+
+            retDir.emplace_back(prev == -1 ? Movement::Dir::NONE :
+                                static_cast<Movement::Dir>((link[prevNode] & DIR_MASK) + 1));
+            retSquare.emplace_back(GetSquare(state[prevNode]));
+
+            prevNode = prev;
+
+        } while (prevNode != -1);
+
+        std::reverse(retDir.begin(), retDir.end());
+        std::reverse(retSquare.begin(), retSquare.end());
+
+        return Solution(Solution::Status::SOLVED, std::move(retDir), std::move(retSquare), depth);
+    }
+}
+
+} // namespace Parallel
+
+} // namespace Solver
@@ -0,0 +1,38 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include "Solver.hpp"
+#include "WorkerPool.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <cstddef>
+
+namespace Solver
+{
+
+namespace Parallel
+{
+
+// Layers with fewer nodes than this are expanded by the calling thread alone,
+// as handing it to the threads would take longer than the layer itself
+static const int DEFAULT_MIN_PARALLEL_NODE = 4096;
+
+// The threads beyond the calling one are taken from the pool.  Only layers of
+// at least minParallelNode nodes are split across them.
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth,
+                             WorkerPool& pool, int numThread,
+                             size_t memoryLimit = DEFAULT_MEMORY_LIMIT,
+                             int minParallelNode = DEFAULT_MIN_PARALLEL_NODE);
+
+} // namespace Parallel
+
+} // namespace Solver
+
+#endif // PARALLEL_HPP
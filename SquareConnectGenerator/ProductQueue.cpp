@@ -0,0 +1,89 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "ProductQueue.hpp"
+
+#include "Generator.hpp"
+
+#include <atomic>
+#include <semaphore>
+#include <memory>
+#include <chrono>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+namespace Generator
+{
+
+ProductQueue::ProductQueue(int capacity) :
+    _capacity(static_cast<size_t>(capacity)),
+    _slot(std::make_unique<Slot[]>(static_cast<size_t>(capacity))),
+    _numFree(capacity)
+{
+    // Precondition check
+    assert(capacity > 0 && capacity <= std::counting_semaphore<>::max());
+
+    for (size_t pos = 0; pos < _capacity; pos++)
+        _slot[pos]._seq.store(pos, std::memory_order_relaxed);
+}
+
+bool ProductQueue::Push(Product&& product)
+{
+    while (!_numFree.try_acquire_for(CLOSE_CHECK_INTERVAL)) {
+        if (_closed.load(std::memory_order_relaxed))
+            return false;
+    }
+
+    if (_closed.load(std::memory_order_relaxed)) {
+        _numFree.release();
+        return false;
+    }
+
+    // A free slot was taken for every position handed out, and the consumer
+    // frees the slots in order, so the slot of the position is free.
+    size_t pos = _head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = _slot[pos % _capacity];
+
+    // Invariant check
+    assert(slot._seq.load(std::memory_order_acquire) == pos);
+
+    slot._product = std::move(product);
+    slot._seq.store(pos + 1, std::memory_order_release);
+    slot._seq.notify_one();
+
+    _numFull.release();
+    return true;
+}
+
+bool ProductQueue::Pop(Product& product, std::chrono::milliseconds timeout)
+{
+    if (!_numFull.try_acquire_for(timeout))
+        return false;
+
+    // A later position may have been filled first, in which case the
+    // producer of this one is still moving its Product in.
+    Slot& slot = _slot[_tail % _capacity];
+
+    for (size_t seq = slot._seq.load(std::memory_order_acquire);
+         seq != _tail + 1;
+         seq = slot._seq.load(std::memory_order_acquire))
+        slot._seq.wait(seq, std::memory_order_acquire);
+
+    product = std::move(slot._product);
+    slot._seq.store(_tail + _capacity, std::memory_order_release);
+    _tail++;
+
+    _numFree.release();
+    return true;
+}
+
+void ProductQueue::Close()
+{
+    _closed.store(true, std::memory_order_relaxed);
+}
+
+} // namespace Generator
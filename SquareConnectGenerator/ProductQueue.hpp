@@ -0,0 +1,82 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef PRODUCT_QUEUE_HPP
+#define PRODUCT_QUEUE_HPP
+
+#include "Generator.hpp"
+
+#include <atomic>
+#include <semaphore>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+
+namespace Generator
+{
+
+// Bounded queue which hands Products from any number of Generator Threads to
+// a single consumer.  Products are moved in and out of a ring of slots, and
+// no lock is held while a Product is moved, so a Push never waits for what
+// the consumer does with the Products it has popped.  A Push only waits while
+// the queue is full, which holds the producers back when the consumer falls
+// behind.
+class ProductQueue
+{
+public:
+
+    static const int DEFAULT_CAPACITY = 64;
+
+    ProductQueue(int capacity = DEFAULT_CAPACITY);
+    ProductQueue(const ProductQueue& queue) = delete;
+    ProductQueue(ProductQueue&& queue) = delete;
+
+    ~ProductQueue() = default;
+
+    ProductQueue& operator=(const ProductQueue& queue) = delete;
+    ProductQueue& operator=(ProductQueue&& queue) = delete;
+
+    // Waits while the queue is full.  Returns false, and leaves the Product
+    // as it is, once the queue is closed.
+    bool Push(Product&& product);
+
+    // Takes the oldest Product, waiting up to the timeout for one.  Returns
+    // false if there is none by then.  Only one thread may Pop.
+    bool Pop(Product& product, std::chrono::milliseconds timeout);
+
+    // Fails every Push from now on.  A Push waiting on a full queue gives up
+    // within CLOSE_CHECK_INTERVAL.
+    void Close();
+
+private:
+
+    // Longest a Push waits before checking whether the queue is closed
+    static constexpr std::chrono::milliseconds CLOSE_CHECK_INTERVAL{ 100 };
+
+    // The sequence of a slot is its next push position while it is free,
+    // and one more than its push position once the Product is in it.
+    struct Slot
+    {
+        std::atomic<size_t> _seq{ 0 };
+        Product _product{ };
+    };
+
+    size_t _capacity{ 0 };
+    std::unique_ptr<Slot[]> _slot{ };
+
+    // Next position to push, taken by the producers in turn
+    std::atomic<size_t> _head{ 0 };
+    // Next position to pop, only used by the consumer
+    size_t _tail{ 0 };
+
+    std::counting_semaphore<> _numFree;
+    std::counting_semaphore<> _numFull{ 0 };
+    std::atomic<bool> _closed{ false };
+};
+
+} // namespace Generator
+
+#endif // PRODUCT_QUEUE_HPP
@@ -583,4 +583,35 @@ bool MatchProfile::ValidateTypeIdentity(const std::vector<TypeIdentity>& typeId)
     return true;
 }
 
+[[nodiscard]] TypeCount CountType(const Square& square)
+{
+    AnalysisProfile analysis = Analyze({ square });
+    TypeCount retCnt{ };
+
+    for (const TypeIsland& tIs : analysis.GetEntryTypeIsland(0))
+        retCnt.at(static_cast<int>(tIs.first))++;
+
+    return retCnt;
+}
+
+[[nodiscard]] bool MatchType(const TypeCount& typeCount, const MatchProfile& match, int num)
+{
+    // Precondition check
+    assert(num >= 0 && num < match.GetNumEntry());
+
+    if (match.GetEntryMode(num) != Mode::COMPARE)
+        return true;
+
+    // Every TypeIdentity needs an Island of its own of the same Type, while
+    // Islands left over are allowed, as in MatchTypeIdentityToTypeIsland.
+    TypeCount numLeft = typeCount;
+
+    for (const TypeIdentity& tId : match.GetEntryTypeIdentity(num)) {
+        if (--numLeft.at(static_cast<int>(tId.first)) < 0)
+            return false;
+    }
+
+    return true;
+}
+
 } // namespace Profiler
\ No newline at end of file
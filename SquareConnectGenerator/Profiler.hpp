@@ -57,6 +57,11 @@ enum class Type : int
     SINGLET_O,
 };
 
+static const int NUM_TYPE = static_cast<int>(Type::SINGLET_O) + 1;
+
+// Number of Islands of each Type
+using TypeCount = std::array<int, NUM_TYPE>;
+
 // An identity identifies a unique island.
 // An island is a unique group of squares which are adjacent to 
 // one another.
@@ -168,6 +173,14 @@ private:
 [[nodiscard]] AnalysisProfile Analyze(const std::vector<Square>& square);
 [[nodiscard]] bool Match(const AnalysisProfile& analysis, const MatchProfile& match);
 
+// Islands of a single Square counted by Type
+[[nodiscard]] TypeCount CountType(const Square& square);
+
+// Checks only the Types of entry num of a MatchProfile against the Islands of a
+// single Square, leaving the Identities out.  A Square which fails this can
+// not be in that place of a matching solution.
+[[nodiscard]] bool MatchType(const TypeCount& typeCount, const MatchProfile& match, int num);
+
 } // namespace Profiler
 
 #endif // PROFILER_HPP
@@ -0,0 +1,80 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Random.hpp"
+
+#include <bit>
+#include <array>
+#include <cstdint>
+#include <cassert>
+
+Random::Random(uint64_t seed)
+{
+    for (uint64_t& s : _state)
+        s = SplitMix(seed);
+}
+
+[[nodiscard]] uint64_t Random::GetNext()
+{
+    uint64_t ret = std::rotl(_state[1] * 5, 7) * 9;
+    uint64_t t = _state[1] << 17;
+
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = std::rotl(_state[3], 45);
+
+    return ret;
+}
+
+// Lemire's method, which scales a 32 bit number by the range and only draws
+// again in the rare case the low half of the product lands in the biased part.
+// The range of every int does not fit in 32 bits, and needs no scaling.
+[[nodiscard]] int Random::GetInt(int min, int max)
+{
+    // Precondition check
+    assert(min <= max);
+
+    uint64_t fullRange = static_cast<uint64_t>(static_cast<int64_t>(max) - min + 1);
+    if (fullRange == (uint64_t(1) << 32))
+        return static_cast<int>(static_cast<int64_t>(min) + static_cast<int64_t>(GetNext() >> 32));
+
+    uint32_t range = static_cast<uint32_t>(fullRange);
+    uint64_t product = (GetNext() >> 32) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+
+    if (low < range) {
+        uint32_t threshold = (0 - range) % range;
+        while (low < threshold) {
+            product = (GetNext() >> 32) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+
+    return static_cast<int>(static_cast<int64_t>(min) + static_cast<int64_t>(product >> 32));
+}
+
+// The top 53 bits fill the mantissa of a double, so every value is as likely
+[[nodiscard]] double Random::GetReal()
+{
+    return static_cast<double>(GetNext() >> 11) * 0x1.0p-53;
+}
+
+[[nodiscard]] uint64_t Random::GetStreamSeed(uint64_t seed, uint64_t num)
+{
+    uint64_t x = seed ^ std::rotl(num * 0xD1B54A32D192ED03, 32);
+    return SplitMix(x);
+}
+
+[[nodiscard]] uint64_t Random::SplitMix(uint64_t& x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
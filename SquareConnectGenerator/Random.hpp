@@ -0,0 +1,51 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <array>
+#include <cstdint>
+
+// Random number generator of the xoshiro256** family.  The sequence only
+// depends on the seed, so anything made from a Random can be made again from
+// the same seed.
+class Random
+{
+public:
+
+    Random(uint64_t seed);
+    Random(const Random& random) = default;
+    Random(Random&& random) noexcept = default;
+
+    ~Random() = default;
+
+    Random& operator=(const Random& random) = default;
+    Random& operator=(Random&& random) noexcept = default;
+
+    [[nodiscard]] uint64_t GetNext();
+
+    // Uniform integer from min to max inclusive, without the bias of taking
+    // a remainder
+    [[nodiscard]] int GetInt(int min, int max);
+
+    // Uniform real from 0 inclusive to 1 exclusive
+    [[nodiscard]] double GetReal();
+
+    // Seed of stream num of a master seed.  Each stream gives an unrelated
+    // sequence, so a run can give each unit of work its own stream and be
+    // the same however the work is split across threads.
+    [[nodiscard]] static uint64_t GetStreamSeed(uint64_t seed, uint64_t num);
+
+private:
+
+    std::array<uint64_t, 4> _state{ };
+
+    // Step of the SplitMix64 generator, which spreads a seed over the state
+    [[nodiscard]] static uint64_t SplitMix(uint64_t& x);
+};
+
+#endif // RANDOM_HPP
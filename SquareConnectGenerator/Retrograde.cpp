@@ -0,0 +1,214 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Retrograde.hpp"
+
+#include "WorkerPool.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Retrograde
+{
+
+static_assert(Square::NUM == 4, "Rank enumeration assumes four squares");
+
+// Cell mask of every Square rank, in rank order.  Enumerating the cells from
+// the most significant one down visits the ranks in ascending order.
+[[nodiscard]] static const std::vector<uint64_t>& GetRankMask()
+{
+    static const std::vector<uint64_t> rankMask = []() {
+
+        std::vector<uint64_t> mask;
+        mask.reserve(Square::NUM_RANK);
+
+        for (int c3 = 3; c3 < Board::NUM_TILES; c3++) {
+            for (int c2 = 2; c2 < c3; c2++) {
+                for (int c1 = 1; c1 < c2; c1++) {
+                    for (int c0 = 0; c0 < c1; c0++) {
+                        mask.emplace_back((static_cast<uint64_t>(1) << c0) |
+                                          (static_cast<uint64_t>(1) << c1) |
+                                          (static_cast<uint64_t>(1) << c2) |
+                                          (static_cast<uint64_t>(1) << c3));
+                    }
+                }
+            }
+        }
+
+        assert(mask.size() == Square::NUM_RANK);
+        return mask;
+    }();
+
+    return rankMask;
+}
+
+// The moves of every Square are calculated once up front, split across
+// threads by rank.  The moves are then reversed so that a Breadth First Search
+// from the solved Squares can reach every Square which slides into a Square
+// of the current layer.  The number of shortest solutions of a Square is the
+// sum of those of the Squares it slides into on the previous layer, which
+// counts every distinct sequence of moves.
+Table::Table(const Board& board, int maxDepth, int numThread)
+{
+    Build(board, maxDepth, numThread);
+}
+
+void Table::Build(const Board& board, int maxDepth, int numThread, Solver::WorkerPool* pool)
+{
+    // Precondition check
+    assert(maxDepth > 0);
+    assert(numThread > 0);
+
+    _maxDepth = maxDepth;
+
+    const std::vector<uint64_t>& rankMask = GetRankMask();
+    const uint64_t walls = board.GetWallMask();
+
+    // Rank of the Square after each move, or -1 if the move did not succeed
+    _nextRank.resize(Square::NUM_RANK);
+
+    auto expand = [&](int begin, int end) {
+
+        for (int rank = begin; rank < end; rank++) {
+
+            _nextRank[rank].fill(-1);
+
+            if (rankMask[rank] & walls)
+                continue;
+
+            Square square = Square::FromMask(rankMask[rank]);
+
+            // Solved Squares are never moved away from
+            if (square.IsSolved())
+                continue;
+
+            for (int d = 0; d < Movement::NUM_DIR; d++) {
+                Movement::Result moveRes = Movement::Move(board, square,
+                                                          static_cast<Movement::Dir>(d + 1));
+                if (moveRes.IsSuccess())
+                    _nextRank[rank][d] = moveRes.GetSquare().GetRank();
+            }
+        }
+    };
+
+    Solver::WorkerPool buildPool;
+    Solver::WorkerPool& expandPool = pool != nullptr ? *pool : buildPool;
+
+    expandPool.Run(numThread, numThread, [&](int num, int) {
+        int begin = static_cast<int>(static_cast<long long>(Square::NUM_RANK) * num / numThread);
+        int end = static_cast<int>(static_cast<long long>(Square::NUM_RANK) * (num + 1) / numThread);
+        expand(begin, end);
+    });
+
+    // Reverse the moves, storing the previous ranks of each rank contiguously
+
+    _prevBegin.assign(static_cast<size_t>(Square::NUM_RANK) + 1, 0);
+
+    for (const auto& next : _nextRank) {
+        for (int rank : next) {
+            if (rank >= 0)
+                _prevBegin[rank + 1]++;
+        }
+    }
+
+    for (int rank = 0; rank < Square::NUM_RANK; rank++)
+        _prevBegin[rank + 1] += _prevBegin[rank];
+
+    _prevRank.resize(_prevBegin.back());
+    _prevEnd.assign(_prevBegin.begin(), _prevBegin.end() - 1);
+
+    for (int rank = 0; rank < Square::NUM_RANK; rank++) {
+        for (int next : _nextRank[rank]) {
+            if (next >= 0)
+                _prevRank[_prevEnd[next]++] = rank;
+        }
+    }
+
+    // Search backward from the solved Squares
+
+    _depth.assign(Square::NUM_RANK, UNSOLVABLE);
+    _numSolution.assign(Square::NUM_RANK, 0);
+    _uniqueMask.resize(static_cast<size_t>(maxDepth) + 1);
+
+    for (auto& mask : _uniqueMask)
+        mask.clear();
+
+    _frontier.clear();
+
+    for (int rank = 0; rank < Square::NUM_RANK; rank++) {
+        if (!(rankMask[rank] & walls) && Square::FromMask(rankMask[rank]).IsSolved()) {
+            _depth[rank] = 0;
+            _numSolution[rank] = 1;
+            _frontier.emplace_back(rank);
+        }
+    }
+
+    for (int depth = 1; depth <= maxDepth && !_frontier.empty(); depth++) {
+
+        _next.clear();
+
+        for (int rank : _frontier) {
+            for (int idx = _prevBegin[rank]; idx < _prevBegin[rank + 1]; idx++) {
+
+                int prev = _prevRank[idx];
+
+                if (_depth[prev] == UNSOLVABLE) {
+                    _depth[prev] = static_cast<int8_t>(depth);
+                    _next.emplace_back(prev);
+                }
+
+                if (_depth[prev] == depth) {
+                    _numSolution[prev] = static_cast<uint8_t>(
+                        std::min(2, _numSolution[prev] + _numSolution[rank]));
+                }
+            }
+        }
+
+        for (int rank : _next) {
+            if (_numSolution[rank] == 1)
+                _uniqueMask[depth].emplace_back(rankMask[rank]);
+        }
+
+        std::swap(_frontier, _next);
+    }
+}
+
+int Table::GetMaxDepth() const
+{
+    return _maxDepth;
+}
+
+int Table::GetDepth(const Square& square) const
+{
+    // Precondition check
+    assert(!_depth.empty());
+
+    return _depth.at(square.GetRank());
+}
+
+bool Table::IsUnique(const Square& square) const
+{
+    // Precondition check
+    assert(!_numSolution.empty());
+
+    return _numSolution.at(square.GetRank()) == 1;
+}
+
+const std::vector<uint64_t>& Table::GetUniqueMask(int depth) const
+{
+    // Precondition check
+    assert(depth >= 0 && depth <= _maxDepth);
+
+    return _uniqueMask.at(depth);
+}
+
+} // namespace Retrograde
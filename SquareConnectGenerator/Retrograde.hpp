@@ -0,0 +1,76 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef RETROGRADE_HPP
+#define RETROGRADE_HPP
+
+#include "WorkerPool.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace Retrograde
+{
+
+// Shortest solution depth of every Square on a single Board, found by
+// searching backward from the solved Squares.  Squares are not told apart,
+// so the table is indexed by Square rank.
+class Table
+{
+public:
+
+    // Depth of Squares which cannot be solved within the maximum depth
+    static const int UNSOLVABLE = -1;
+
+    Table() = default;
+    Table(const Board& board, int maxDepth, int numThread = 1);
+    Table(const Table& table) = default;
+    Table(Table&& table) noexcept = default;
+
+    ~Table() = default;
+
+    Table& operator=(const Table& table) = default;
+    Table& operator=(Table&& table) noexcept = default;
+
+    // Fill the table for another Board.  The arrays of the earlier Board are
+    // kept, so a Table which is built again does not allocate.
+    // Any threads beyond the calling one are taken from the pool, or
+    // started for the Build without one.
+    void Build(const Board& board, int maxDepth, int numThread = 1,
+               Solver::WorkerPool* pool = nullptr);
+
+    int GetMaxDepth() const;
+    int GetDepth(const Square& square) const;
+    // Whether only a single sequence of moves solves the Square at its depth
+    bool IsUnique(const Square& square) const;
+
+    // Cell masks of every Square at a depth which has a unique solution
+    const std::vector<uint64_t>& GetUniqueMask(int depth) const;
+
+private:
+
+    int _maxDepth{ 0 };
+    std::vector<int8_t> _depth{ };
+    // Number of shortest solutions, saturated at 2
+    std::vector<uint8_t> _numSolution{ };
+    std::vector<std::vector<uint64_t>> _uniqueMask{ };
+
+    // Arrays only used while the table is built
+    std::vector<std::array<int, Movement::NUM_DIR>> _nextRank{ };
+    std::vector<int> _prevBegin{ };
+    std::vector<int> _prevEnd{ };
+    std::vector<int> _prevRank{ };
+    std::vector<int> _frontier{ };
+    std::vector<int> _next{ };
+};
+
+} // namespace Retrograde
+
+#endif // RETROGRADE_HPP
@@ -6,21 +6,35 @@
 
 #include "Solver.hpp"
 
+#include "Context.hpp"
+#include "NodeStore.hpp"
+#include "Cache.hpp"
+#include "Bidirectional.hpp"
+#include "IterativeDeepening.hpp"
+#include "Parallel.hpp"
+#include "Symmetry.hpp"
 #include "Util.hpp"
 #include "Movement.hpp"
 #include "Board.hpp"
 #include "Square.hpp"
 #include "Pos.hpp"
+#include "Bits.hpp"
+#include "BoardSize.hpp"
 
+#include <thread>
+#include <mutex>
 #include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
 #include <cassert>
-#include <cmath>
 
 namespace Solver
 {
 
-Solution::Solution(Status status, std::vector<Movement::Dir> dirs,
-                   std::vector<Square> squares, int depth) :
+template <int ROW, int COL>
+BasicSolution<ROW, COL>::BasicSolution(Status status, std::vector<Movement::Dir> dirs,
+                                       std::vector<SquareType> squares, int depth) :
     _status(status),
     _dirs(std::move(dirs)),
     _squares(std::move(squares)),
@@ -28,7 +42,8 @@ Solution::Solution(Status status, std::vector<Movement::Dir> dirs,
 {
 }
 
-bool Solution::operator==(const Solution& solution) const
+template <int ROW, int COL>
+bool BasicSolution<ROW, COL>::operator==(const BasicSolution& solution) const
 {
     if ((_status != solution._status) ||
         (_dirs != solution._dirs) ||
@@ -39,238 +54,221 @@ bool Solution::operator==(const Solution& solution) const
     // Process this last as this is significantly costlier
     for (int dep = 0; dep < _depth; dep++) {
         if ((_squares.at(dep) == solution._squares.at(dep)) ==
-            Square::Equality::NOT_EQUAL)
+            SquareType::Equality::NOT_EQUAL)
             return false;
     }
 
     return true;
 }
 
-Solution::Status Solution::GetStatus() const
+template <int ROW, int COL>
+typename BasicSolution<ROW, COL>::Status BasicSolution<ROW, COL>::GetStatus() const
 {
     return _status;
 }
 
-const std::vector<Movement::Dir>& Solution::GetDir() const
+template <int ROW, int COL>
+const std::vector<Movement::Dir>& BasicSolution<ROW, COL>::GetDir() const
 {
     return _dirs;
 }
 
-const std::vector<Square>& Solution::GetSquare() const
+template <int ROW, int COL>
+const std::vector<typename BasicSolution<ROW, COL>::SquareType>&
+BasicSolution<ROW, COL>::GetSquare() const
 {
     return _squares;
 }
 
-int Solution::GetDepth() const
+template <int ROW, int COL>
+int BasicSolution<ROW, COL>::GetDepth() const
 {
     return _depth;
 }
 
-class Node
-{
-public:
-
-    Node() = default;
-    Node(Movement::Dir dir, Square square, bool solved = false,
-         int prevIdx = -1, int depth = 0, int repeatedDepth = 0);
-    Node(const Node& node) = default;
-    Node(Node&& node) noexcept = default;
-    ~Node() = default;
-
-    Node& operator=(const Node& node) = default;
-    Node& operator=(Node&& node) noexcept = default;
-
-    Movement::Dir GetDir() const;
-    Square& GetSquare();
-    bool GetSolved() const;
-    int GetPrevNode() const;
-    int GetDepth() const;
-    int GetRepeatedDepth() const;
-    void SetRepeatedDepth(int depth);
-
-private:
-
-    Movement::Dir _dir{ Movement::Dir::NONE };
-    Square _square{ };
-    bool _solved{ false };
-    int _prevNode{ -1 };
-    int _depth{ 0 };
-    int _repeatedDepth{ 0 };
-};
-
-Node::Node(Movement::Dir dir, Square square, bool solved,
-           int prevNode, int depth, int repeatedDepth) :
-    _dir(dir),
-    _square(std::move(square)),
-    _solved(solved),
-    _prevNode(prevNode),
-    _depth(depth),
-    _repeatedDepth(repeatedDepth)
+long long CacheStatistics::GetHit() const
 {
+    return _hit;
 }
 
-Movement::Dir Node::GetDir() const
+long long CacheStatistics::GetMiss() const
 {
-    return _dir;
+    return _miss;
 }
 
-Square& Node::GetSquare()
+long long CacheStatistics::GetEviction() const
 {
-    return _square;
+    return _eviction;
 }
 
-bool Node::GetSolved() const
+void CacheStatistics::AddHit()
 {
-    return _solved;
+    _hit++;
 }
 
-int Node::GetPrevNode() const
+void CacheStatistics::AddMiss()
 {
-    return _prevNode;
+    _miss++;
 }
 
-int Node::GetDepth() const
+void CacheStatistics::AddEviction()
 {
-    return _depth;
+    _eviction++;
 }
 
-int Node::GetRepeatedDepth() const
+void CacheStatistics::Add(const CacheStatistics& statistics)
 {
-    return _repeatedDepth;
+    _hit += statistics._hit;
+    _miss += statistics._miss;
+    _eviction += statistics._eviction;
 }
 
-void Node::SetRepeatedDepth(int depth)
-{
-    _repeatedDepth = depth;
-}
+// Each thread adds the statistics of its cache to those of every thread
+// once every CACHE_STATISTICS_INTERVAL lookups, so that the threads seldom
+// wait on each other
+static const int CACHE_STATISTICS_INTERVAL = 1024;
+
+static thread_local Cache _cache;
+static thread_local int _numCacheLookup{ 0 };
+static thread_local Context _context;
+
+static std::mutex _cacheMutex;
+static CacheStatistics _cacheStatistics;
 
 // Use Breadth First Search to search for shortest possible solution.  The puzzle
 // is only deemed solvable if there is only a single shortest solution possible.
 // The puzzle is not solvable if there is another shortest solution with a different
 // Square position, or similiar Square position but different Movement::Dir set.
-[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth)
+//
+// Each node counts the shortest paths which lead to it.  A node found again
+// within the layer it was first found in gains the paths of the node it was
+// found from, so the paths into the solved nodes give the number of shortest
+// solutions in a single pass.
+template <int ROW, int COL>
+[[nodiscard]] static BasicSolution<ROW, COL> SearchBreadthFirst(const BasicBoard<ROW, COL>& board,
+                                                               const BasicSquare<ROW, COL>& square,
+                                                               int maxDepth,
+                                                               NodeStore<ROW, COL>& nodes)
 {
-    // Precondition check
-    assert(Util::IsBoardSquareSane(board, square));
-    assert(!square.IsSolved());
-    assert(maxDepth > 0);
+    using SolutionType = BasicSolution<ROW, COL>;
+    using SquareType = BasicSquare<ROW, COL>;
+    using NodeType = Node<ROW, COL>;
+    using Status = typename SolutionType::Status;
 
-    // Use Geometric Series to calculate maximum number of required nodes:
-    //
-    //      r * (1 - r^n) / (1 - r)
-    //
-    // where
-    //     r == Square::NUM
-    //     n == maxDepth + 1 (extra 1 for starting node)
-    std::vector<Node> nodes;
-    nodes.reserve(static_cast<long long>(
-                  Square::NUM * (1 - std::pow(Square::NUM, maxDepth + 1)) /
-                  (1 - Square::NUM)));
+    // Precondition check
+    assert(nodes.GetSize() == 0);
 
     int nodeCount = 0;
-    Solution::Status solStatus = Solution::Status::NONE;
-    size_t solNode = 0;
+    // Index of the first node after the layer being searched
+    int layerEnd = 1;
+    int oldDepth = 0;
+    Status solStatus = Status::NONE;
+    int solNode = 0;
     int solDepth = 0;
+    int solNumPath = 0;
+
+    if (!nodes.Add(NodeType(Movement::Dir::NONE, square)))
+        return SolutionType(Status::MEMORY_LIMIT_REACHED);
 
-    nodes.emplace_back(Node(Movement::Dir::NONE, square, false, -1, 0, 0));
+    while (nodeCount != nodes.GetSize()) {
 
-    while (nodeCount != nodes.size()) {
+        if (nodeCount == layerEnd) {
+            layerEnd = nodes.GetSize();
+            oldDepth++;
+        }
 
-        if (nodes.at(nodeCount).GetSolved()) {
+        if (nodes.At(nodeCount).GetSolved()) {
             nodeCount++;
             continue;
         }
 
-        const Square& oldSquare = nodes.at(nodeCount).GetSquare();
-        int oldDepth = nodes.at(nodeCount).GetDepth();
+        const SquareType oldSquare = nodes.At(nodeCount).GetSquare();
+        int oldNumPath = nodes.At(nodeCount).GetNumPath();
         int newDepth = oldDepth + 1;
 
         // Ensure that all nodes with the same depth of solution found has been searched.
         // This is so we can detect the condition where there is another solution with
         // the same depth as the solution depth.
-        if (solStatus == Solution::Status::SOLVED && newDepth > solDepth)
+        if (solStatus == Status::SOLVED && newDepth > solDepth)
             break;
 
         if (newDepth > maxDepth) {
-            solStatus = Solution::Status::MAX_DEPTH_REACHED;
+            solStatus = Status::MAX_DEPTH_REACHED;
             break;
         }
 
+        Movement::BasicResultAll<ROW, COL> moveRes = Movement::MoveAll(board, oldSquare);
+
         for (Movement::Dir dir = Movement::Dir::UP;
              dir <= Movement::Dir::RIGHT;
              dir = static_cast<Movement::Dir>(static_cast<int>(dir) + 1)) {
 
-            Movement::Result moveRes = Movement::Move(board, oldSquare, dir);
-            if (!moveRes.IsSuccess())
+            if (!moveRes.IsSuccess(dir))
                 continue;
 
-            const Square& newSquare = moveRes.GetSquare();
+            const SquareType newSquare = moveRes.GetSquare(dir);
             bool newSolved = newSquare.IsSolved();
 
-            bool repeated = false;
-
-            for (auto& node : nodes) {
-
-                if ((newSquare == node.GetSquare()) == Square::Equality::NOT_EQUAL)
-                    continue;
-
-                // Only keep track of smallest repeated depth
-                if (newDepth < node.GetRepeatedDepth())
-                    node.SetRepeatedDepth(newDepth);
+            int idx = nodes.Find(newSquare.GetMask());
 
-                repeated = true;
-                break;
+            if (idx >= 0) {
+                // Paths through an earlier layer are not shortest paths
+                if (idx >= layerEnd)
+                    nodes.At(idx).AddNumPath(oldNumPath);
+            } else {
+                idx = nodes.GetSize();
+                if (!nodes.Add(NodeType(dir, newSquare, nodeCount, oldNumPath)))
+                    return SolutionType(Status::MEMORY_LIMIT_REACHED);
             }
 
-            if (!repeated)
-                nodes.emplace_back(Node(dir, newSquare, newSolved, nodeCount, newDepth));
-
             if (newSolved) {
 
-                if (solStatus == Solution::Status::NONE) {
-                    solStatus = Solution::Status::SOLVED;
-                    solNode = nodes.size() - 1;
+                if (solStatus == Status::NONE) {
+                    solStatus = Status::SOLVED;
+                    solNode = idx;
                     solDepth = newDepth;
+                }
+
+                solNumPath += oldNumPath;
 
-                } else if (newDepth == solDepth) {
-                    solStatus = Solution::Status::SHORTEST_SOLUTION_REPEATED;
+                if (solNumPath >= MAX_NUM_PATH) {
+                    solStatus = Status::SHORTEST_SOLUTION_REPEATED;
                     break;
                 }
             }
         }
 
-        if (solStatus == Solution::Status::SHORTEST_SOLUTION_REPEATED)
+        if (solStatus == Status::SHORTEST_SOLUTION_REPEATED)
             break;
 
         nodeCount++;
     }
 
-    if (solStatus != Solution::Status::SOLVED) {
-        if (solStatus == Solution::Status::NONE)
-            return Solution(Solution::Status::UNSOLVABLE);
+    if (solStatus != Status::SOLVED) {
+        if (solStatus == Status::NONE)
+            return SolutionType(Status::UNSOLVABLE);
         else
-            return Solution(solStatus);
+            return SolutionType(solStatus);
     }
 
     // Construct solution
 
     std::vector<Movement::Dir> retDir;
-    retDir.reserve(solDepth);
+    retDir.reserve(solDepth + 1);
 
-    std::vector<Square> retSquare;
-    retSquare.reserve(solDepth);
+    std::vector<SquareType> retSquare;
+    retSquare.reserve(solDepth + 1);
 
-    size_t prevNode = solNode;
+    int prevNode = solNode;
 
     do {
-        Node& n = nodes.at(prevNode);
+        const NodeType& n = nodes.At(prevNode);
 
-        if (n.GetRepeatedDepth() > 0 && n.GetRepeatedDepth() <= n.GetDepth())
-            return Solution(Solution::Status::SHORTEST_SOLUTION_REPEATED);
+        // Invariant check
+        assert(n.GetNumPath() == 1);
 
         retDir.emplace_back(n.GetDir());
-        // Safe to move as nodes are no longer needed beyond this point
-        retSquare.emplace_back(std::move(n.GetSquare()));
+        retSquare.emplace_back(n.GetSquare());
 
         prevNode = n.GetPrevNode();
 
@@ -279,7 +277,83 @@ void Node::SetRepeatedDepth(int depth)
     std::reverse(retDir.begin(), retDir.end());
     std::reverse(retSquare.begin(), retSquare.end());
 
-    return Solution(solStatus, std::move(retDir), std::move(retSquare), solDepth);
+    return SolutionType(solStatus, std::move(retDir), std::move(retSquare), solDepth);
+}
+
+template <int ROW, int COL>
+[[nodiscard]] BasicSolution<ROW, COL> SolveBreadthFirst(const BasicBoard<ROW, COL>& board,
+                                                        const BasicSquare<ROW, COL>& square,
+                                                        int maxDepth, size_t memoryLimit)
+{
+    // Precondition check
+    assert(Util::IsBoardSquareSane(board, square));
+    assert(!square.IsSolved());
+    assert(maxDepth > 0);
+
+    NodeStore<ROW, COL> nodes(memoryLimit);
+    return SearchBreadthFirst(board, square, maxDepth, nodes);
+}
+
+// Every hardware thread, or a single one if their number is not known
+[[nodiscard]] static int GetNumThread()
+{
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth,
+                             Mode mode, size_t memoryLimit)
+{
+    return Solve(board, square, maxDepth, _context, mode, memoryLimit);
+}
+
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth,
+                             Context& context, Mode mode, size_t memoryLimit)
+{
+    // Precondition check
+    assert(Util::IsBoardSquareSane(board, square));
+    assert(!square.IsSolved());
+    assert(maxDepth > 0);
+
+    if (++_numCacheLookup == CACHE_STATISTICS_INTERVAL) {
+        _numCacheLookup = 0;
+        auto lock = std::scoped_lock{ _cacheMutex };
+        _cacheStatistics.Add(_cache.TakeStatistics());
+    }
+
+    Symmetry::Transform trans = Symmetry::GetCanonicalTransform(board, square);
+    Cache::Key key(board, square, trans, mode, memoryLimit);
+
+    if (const Solution* sol = _cache.Find(key, maxDepth))
+        return Symmetry::Apply(Symmetry::GetInverse(trans), *sol);
+
+    Solution retSol;
+
+    if (mode == Mode::BIDIRECTIONAL)
+        retSol = Bidirectional::Solve(board, square, maxDepth);
+    else if (mode == Mode::ITERATIVE_DEEPENING)
+        retSol = IterativeDeepening::Solve(board, square, maxDepth);
+    else if (mode == Mode::PARALLEL_BREADTH_FIRST)
+        retSol = Parallel::Solve(board, square, maxDepth, context.GetPool(), GetNumThread(),
+                                 memoryLimit);
+    else
+        retSol = SearchBreadthFirst(board, square, maxDepth, context.GetNodeStore(memoryLimit));
+
+    _cache.Insert(key, maxDepth, Symmetry::Apply(trans, retSol));
+    return retSol;
+}
+
+[[nodiscard]] CacheStatistics GetCacheStatistics()
+{
+    auto lock = std::scoped_lock{ _cacheMutex };
+    _cacheStatistics.Add(_cache.TakeStatistics());
+    return _cacheStatistics;
 }
 
+#define INSTANTIATE(ROW, COL) \
+    template class BasicSolution<ROW, COL>; \
+    template BasicSolution<ROW, COL> SolveBreadthFirst(const BasicBoard<ROW, COL>&, \
+                                                       const BasicSquare<ROW, COL>&, int, size_t);
+BOARD_SIZE_LIST(INSTANTIATE)
+#undef INSTANTIATE
+
 } // namespace Solver
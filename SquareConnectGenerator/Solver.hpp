@@ -8,17 +8,24 @@
 #define SOLVER_HPP
 
 #include "Movement.hpp"
+#include "Board.hpp"
 #include "Square.hpp"
 
 #include <vector>
+#include <cstddef>
 
 namespace Solver
 {
 
-class Solution
+// Solution of a puzzle on a BasicBoard.  Solution is the Solution of the 8x8
+// Board.
+template <int ROW, int COL>
+class BasicSolution
 {
 public:
 
+    using SquareType = BasicSquare<ROW, COL>;
+
     enum class Status : int
     {
         NONE = 0,
@@ -26,35 +33,120 @@ public:
         UNSOLVABLE,
         MAX_DEPTH_REACHED,
         SHORTEST_SOLUTION_REPEATED,
+        MEMORY_LIMIT_REACHED,
     };
 
-    Solution() = default;
-    Solution(Status status, std::vector<Movement::Dir> dirs = { },
-             std::vector<Square> squares = { }, int depth = 0);
-    Solution(const Solution& solution) = default;
-    Solution(Solution&& solution) noexcept = default;
+    BasicSolution() = default;
+    BasicSolution(Status status, std::vector<Movement::Dir> dirs = { },
+                  std::vector<SquareType> squares = { }, int depth = 0);
+    BasicSolution(const BasicSolution& solution) = default;
+    BasicSolution(BasicSolution&& solution) noexcept = default;
 
-    ~Solution() = default;
+    ~BasicSolution() = default;
 
-    Solution& operator=(const Solution& solution) = default;
-    Solution& operator=(Solution&& solution) noexcept = default;
+    BasicSolution& operator=(const BasicSolution& solution) = default;
+    BasicSolution& operator=(BasicSolution&& solution) noexcept = default;
 
-    bool operator==(const Solution& solution) const;
+    bool operator==(const BasicSolution& solution) const;
 
     Status GetStatus() const;
     const std::vector<Movement::Dir>& GetDir() const;
-    const std::vector<Square>& GetSquare() const;
+    const std::vector<SquareType>& GetSquare() const;
     int GetDepth() const;
 
 private:
 
     Status _status{ Status::NONE };
     std::vector<Movement::Dir> _dirs{ };
-    std::vector<Square> _squares{ };
+    std::vector<SquareType> _squares{ };
     int _depth{ 0 };
 };
 
-[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth);
+using Solution = BasicSolution<8, 8>;
+
+// Number of shortest paths is only counted up to this, as the puzzle is not
+// solvable as soon as there is more than one.
+static const int MAX_NUM_PATH = 2;
+
+enum class Mode : int
+{
+    BREADTH_FIRST = 0,
+    // Search forward from the Square and backward from every solved Square
+    // on the Board, and join the two searches where they meet.  Considerably
+    // fewer Squares are searched for deep solutions.
+    BIDIRECTIONAL,
+    // Iterative Deepening A* with a lower bound from the distance of each
+    // square to a 2x2 block.  Memory stays small however deep the search.
+    // The Solution is the same as with BREADTH_FIRST, except that
+    // UNSOLVABLE and MAX_DEPTH_REACHED may be swapped.
+    ITERATIVE_DEEPENING,
+    // Breadth First Search with each layer split across every hardware
+    // thread.  The Solution is the same as with BREADTH_FIRST.
+    PARALLEL_BREADTH_FIRST,
+};
+
+// Memory the Breadth First Search may use for its nodes before giving up with
+// Solution::Status::MEMORY_LIMIT_REACHED
+static const size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+class CacheStatistics
+{
+public:
+
+    CacheStatistics() = default;
+    CacheStatistics(const CacheStatistics& statistics) = default;
+    CacheStatistics(CacheStatistics&& statistics) noexcept = default;
+
+    ~CacheStatistics() = default;
+
+    CacheStatistics& operator=(const CacheStatistics& statistics) = default;
+    CacheStatistics& operator=(CacheStatistics&& statistics) noexcept = default;
+
+    long long GetHit() const;
+    long long GetMiss() const;
+    long long GetEviction() const;
+
+    void AddHit();
+    void AddMiss();
+    void AddEviction();
+    void Add(const CacheStatistics& statistics);
+
+private:
+
+    long long _hit{ 0 };
+    long long _miss{ 0 };
+    long long _eviction{ 0 };
+};
+
+class Context;
+
+// Solutions are cached per thread, so repeating a Solve with the same
+// arguments on the same thread returns a copy of the earlier Solution, as does
+// a Solve of the same puzzle rotated or flipped, with the Solution rotated or
+// flipped the same way.  The Breadth First Search takes its nodes from a
+// Context of the calling thread.
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth,
+                             Mode mode = Mode::BREADTH_FIRST,
+                             size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+// Same as above, with the nodes of the Breadth First Search taken from the
+// Context given
+[[nodiscard]] Solution Solve(const Board& board, const Square& square, int maxDepth,
+                             Context& context, Mode mode = Mode::BREADTH_FIRST,
+                             size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+// Breadth First Search of a Board of any size in BoardSize.hpp, uncached.  The
+// other modes only search the 8x8 Board.
+template <int ROW, int COL>
+[[nodiscard]] BasicSolution<ROW, COL> SolveBreadthFirst(const BasicBoard<ROW, COL>& board,
+                                                        const BasicSquare<ROW, COL>& square,
+                                                        int maxDepth,
+                                                        size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+// Statistics of the Solution caches of every thread.  Those of the calling
+// thread are up to date, while those of the other threads may be behind by
+// up to a thousand or so lookups each.
+[[nodiscard]] CacheStatistics GetCacheStatistics();
 
 };
 
@@ -6,194 +6,271 @@
 
 #include "Square.hpp"
 
+#include "Board.hpp"
+#include "Bits.hpp"
+#include "BoardSize.hpp"
+
 #include <array>
 #include <vector>
+#include <cstdint>
 #include <utility>
 #include <cassert>
 
+static_assert(Square::NUM == 4, "Square ranks assume four squares");
+
+// Binomial coefficients C(n, k) for n up to NUM_TILES and k up to NUM
+template <int NUM_TILES>
+static constexpr auto BINOMIAL = []() {
+
+    std::array<std::array<int, Square::NUM + 1>, NUM_TILES + 1> binomial{ };
+
+    for (int n = 0; n <= NUM_TILES; n++) {
+        binomial[n][0] = 1;
+        for (int k = 1; k <= Square::NUM; k++)
+            binomial[n][k] = (n == 0) ? 0 : binomial[n - 1][k - 1] + binomial[n - 1][k];
+    }
+
+    return binomial;
+}();
+
+static_assert(BINOMIAL<Board::NUM_TILES>[Board::NUM_TILES][Square::NUM] == Square::NUM_RANK);
+
 #define INVARIANT_CHECK() \
-    
 
-Square::Square()
+
+template <int ROW, int COL>
+BasicSquare<ROW, COL>::BasicSquare() :
+    _cells{ static_cast<int8_t>(BoardType::GetCell(Pos(-1, -1))),
+            static_cast<int8_t>(BoardType::GetCell(Pos(-1, -2))),
+            static_cast<int8_t>(BoardType::GetCell(Pos(-1, -3))),
+            static_cast<int8_t>(BoardType::GetCell(Pos(-1, -4))) }
+{
+    // Invariant check
+    assert(!IsCellRepeated(_cells));
+}
+
+template <int ROW, int COL>
+BasicSquare<ROW, COL>::BasicSquare(std::vector<Pos> pos)
 {
-    _squares.reserve(NUM);
-    _squares.emplace_back(Pos(-1, -1));
-    _squares.emplace_back(Pos(-1, -2));
-    _squares.emplace_back(Pos(-1, -3));
-    _squares.emplace_back(Pos(-1, -4));
+    // Precondition check
+    assert(pos.size() == NUM);
+    assert(!IsPosRepeated(pos));
+
+    for (int n = 0; n < NUM; n++)
+        _cells.at(n) = static_cast<int8_t>(BoardType::GetCell(pos.at(n)));
 
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(!IsCellRepeated(_cells));
 }
 
-Square::Square(std::vector<Pos> pos) :
-    _squares{ std::move(pos) }
+template <int ROW, int COL>
+BasicSquare<ROW, COL>::BasicSquare(const Cells& cells) :
+    _cells{ cells }
 {
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(!IsCellRepeated(_cells));
 }
 
-Square::Equality Square::operator==(const Square& square) const
+template <int ROW, int COL>
+typename BasicSquare<ROW, COL>::Equality
+BasicSquare<ROW, COL>::operator==(const BasicSquare& square) const
 {
-    // Precondition check
-    assert(square._squares.size() == NUM);
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(!IsCellRepeated(_cells));
+
+    if (_cells == square._cells)
+        return Equality::PERFECTLY_EQUAL;
 
     std::array<bool, NUM> match{ false, false, false, false };
-    int nExact = 0;
-    int nSomewhat = 0;
+    int nMatch = 0;
 
     for (int n1 = 0; n1 < NUM; n1++) {
         for (int n2 = 0; n2 < NUM; n2++) {
 
-            if (match.at(n2))
+            if (match[n2])
                 continue;
 
-            if (_squares.at(n1) == square._squares.at(n2)) {
-                if (n1 == n2)
-                    nExact++;
-                else
-                    nSomewhat++;
-
-                match.at(n2) = true;
+            if (_cells[n1] == square._cells[n2]) {
+                nMatch++;
+                match[n2] = true;
             }
         }
     }
 
-    if (nExact == NUM && nSomewhat == 0)
-        return Equality::PERFECTLY_EQUAL;
-    else if(nExact + nSomewhat == NUM)
+    if (nMatch == NUM)
         return Equality::SOMEWHAT_EQUAL;
- 
+
     return Equality::NOT_EQUAL;
 }
 
-Pos Square::GetPos(int num) const
+template <int ROW, int COL>
+Pos BasicSquare<ROW, COL>::GetPos(int num) const
 {
     // Precondition check
     assert(num >= 0 && num < NUM);
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(!IsCellRepeated(_cells));
 
-    return _squares.at(num);
+    return BoardType::GetPos(_cells.at(num));
 }
 
-bool Square::SetPos(int num, const Pos& pos)
+template <int ROW, int COL>
+bool BasicSquare<ROW, COL>::SetPos(int num, const Pos& pos)
 {
     // Precondition check
     assert(num >= 0 && num < NUM);
+    assert(pos.GetRow() >= 0 && pos.GetRow() < BoardType::NUM_ROW);
+    assert(pos.GetCol() >= 0 && pos.GetCol() < BoardType::NUM_COL);
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(!IsCellRepeated(_cells));
+
+    int8_t cell = static_cast<int8_t>(BoardType::GetCell(pos));
 
     for (int i = 0; i < NUM; i++) {
         if (i == num)
             continue;
-        if (_squares.at(i) == pos) {
+        if (_cells.at(i) == cell) {
             INVARIANT_CHECK();
             return false;
         }
     }
-    _squares.at(num) = pos;
+    _cells.at(num) = cell;
 
     INVARIANT_CHECK();
     return true;
 }
 
-bool Square::SetPos(std::vector<Pos>& pos)
+template <int ROW, int COL>
+bool BasicSquare<ROW, COL>::SetPos(std::vector<Pos>& pos)
 {
     // Precondition check
     assert(pos.size() == NUM);
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(!IsCellRepeated(_cells));
 
     if (IsPosRepeated(pos)) {
         INVARIANT_CHECK();
         return false;
     }
-    _squares = pos;
+
+    for (int n = 0; n < NUM; n++)
+        _cells.at(n) = static_cast<int8_t>(BoardType::GetCell(pos.at(n)));
 
     INVARIANT_CHECK();
     return true;
 }
 
-bool Square::SetPos(std::vector<Pos>&& pos)
+template <int ROW, int COL>
+bool BasicSquare<ROW, COL>::SetPos(std::vector<Pos>&& pos)
+{
+    return SetPos(pos);
+}
+
+template <int ROW, int COL>
+int BasicSquare<ROW, COL>::GetCell(int num) const
 {
     // Precondition check
-    assert(pos.size() == NUM);
-    // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(num >= 0 && num < NUM);
 
-    if (IsPosRepeated(pos))
-        return false;
- 
-    _squares = std::move(pos);
+    return _cells[num];
+}
 
-    // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
-    return true;
+template <int ROW, int COL>
+const typename BasicSquare<ROW, COL>::Cells& BasicSquare<ROW, COL>::GetCells() const
+{
+    return _cells;
 }
 
-int Square::IsPosSquare(const Pos& pos) const
+template <int ROW, int COL>
+typename BasicSquare<ROW, COL>::Mask BasicSquare<ROW, COL>::GetMask() const
+{
+    // Precondition check
+    assert(_cells[0] >= 0 && _cells[1] >= 0 && _cells[2] >= 0 && _cells[3] >= 0);
+
+    return Bits::GetBit<Mask>(_cells[0]) | Bits::GetBit<Mask>(_cells[1]) |
+           Bits::GetBit<Mask>(_cells[2]) | Bits::GetBit<Mask>(_cells[3]);
+}
+
+template <int ROW, int COL>
+BasicSquare<ROW, COL> BasicSquare<ROW, COL>::FromMask(Mask mask)
+{
+    // Precondition check
+    assert(Bits::PopCount(mask) == NUM);
+
+    Cells cells{ };
+
+    for (int num = 0; num < NUM; num++) {
+        cells[num] = static_cast<int8_t>(Bits::CountrZero(mask));
+        mask &= mask - Mask(1);
+    }
+
+    return BasicSquare(cells);
+}
+
+template <int ROW, int COL>
+int BasicSquare<ROW, COL>::GetRank() const
+{
+    return GetRank(GetMask());
+}
+
+// Use the combinatorial number system, which sums C(cell, k) over the cells
+// in ascending order with k counting up from 1.
+template <int ROW, int COL>
+int BasicSquare<ROW, COL>::GetRank(Mask mask)
+{
+    // Precondition check
+    assert(Bits::PopCount(mask) == NUM);
+
+    int rank = 0;
+
+    for (int k = 1; k <= NUM; k++) {
+        rank += BINOMIAL<BoardType::NUM_TILES>[Bits::CountrZero(mask)][k];
+        mask &= mask - Mask(1);
+    }
+
+    return rank;
+}
+
+template <int ROW, int COL>
+int BasicSquare<ROW, COL>::IsPosSquare(const Pos& pos) const
 {
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
+    assert(!IsCellRepeated(_cells));
 
     for (int n = 0; n < NUM; n++) {
-        if (_squares.at(n) == pos)
+        if (GetPos(n) == pos)
             return n;
     }
     return -1;
 }
 
-bool Square::IsSolved() const
+template <int ROW, int COL>
+bool BasicSquare<ROW, COL>::IsSolved() const
 {
     // Invariant check
-    assert(_squares.size() == NUM);
-    assert(!IsPosRepeated(_squares));
-
-    int minRow, maxRow;
-    int minCol, maxCol;
-
-    minRow = maxRow = _squares.at(0).GetRow();
-    minCol = maxCol = _squares.at(0).GetCol();
+    assert(!IsCellRepeated(_cells));
 
-    for (int i = 1; i < NUM; i++) {
-
-        int row = _squares.at(i).GetRow();
-        int col = _squares.at(i).GetCol();
+    for (int n = 0; n < NUM; n++) {
+        if (_cells[n] < 0)
+            return false;
+    }
 
-        // We can use if, else (rather than if, if) since
-        // min and max as is initialized as the same value
-        // before the for loop. This will not be possible if
-        // they have been assigned different values.
-        if (row < minRow)
-            minRow = row;
-        else if (row > maxRow)
-            maxRow = row;
+    // A solved Square occupies a 2x2 block, which is the top left square
+    // together with the squares to its right, below and below right.  The
+    // column check prevents the block from wrapping around to the next row.
+    Mask mask = GetMask();
+    int topLeft = Bits::CountrZero(mask);
 
-        if (col < minCol)
-            minCol = col;
-        else if (col > maxCol)
-            maxCol = col;
-    }
+    if (topLeft % BoardType::NUM_COL == BoardType::NUM_COL - 1)
+        return false;
 
-    if (maxRow - minRow == 1 && maxCol - minCol == 1)
-        return true;
+    Mask block = Mask(0x3) | (Mask(0x3) << BoardType::NUM_COL);
 
-    return false;
+    return mask == (block << topLeft);
 }
 
-bool Square::IsPosRepeated(const std::vector<Pos>& pos) const
+template <int ROW, int COL>
+bool BasicSquare<ROW, COL>::IsPosRepeated(const std::vector<Pos>& pos) const
 {
     for (int n1 = 0; n1 < NUM; n1++) {
         for (int n2 = 0; n2 < NUM; n2++) {
@@ -205,3 +282,19 @@ bool Square::IsPosRepeated(const std::vector<Pos>& pos) const
     }
     return false;
 }
+
+template <int ROW, int COL>
+bool BasicSquare<ROW, COL>::IsCellRepeated(const Cells& cells) const
+{
+    for (int n1 = 0; n1 < NUM; n1++) {
+        for (int n2 = n1 + 1; n2 < NUM; n2++) {
+            if (cells[n1] == cells[n2])
+                return true;
+        }
+    }
+    return false;
+}
+
+#define INSTANTIATE(ROW, COL) template class BasicSquare<ROW, COL>;
+BOARD_SIZE_LIST(INSTANTIATE)
+#undef INSTANTIATE
@@ -7,17 +7,31 @@
 #ifndef SQUARE_HPP
 #define SQUARE_HPP
 
+#include "Board.hpp"
 #include "Pos.hpp"
 
+#include <array>
 #include <vector>
+#include <cstdint>
 #include <utility>
 #include <exception>
 
-class Square
+// Squares on a BasicBoard of the same size.  Square is the Square of the 8x8
+// Board.
+template <int ROW, int COL>
+class BasicSquare
 {
 public:
 
+    using BoardType = BasicBoard<ROW, COL>;
+    using Mask = typename BoardType::Mask;
+
     static const int NUM = 4;
+    // Number of ways to place NUM squares on the Board, regardless of order
+    static const int NUM_RANK = BoardType::NUM_TILES * (BoardType::NUM_TILES - 1) *
+                                (BoardType::NUM_TILES - 2) * (BoardType::NUM_TILES - 3) / 24;
+
+    using Cells = std::array<int8_t, NUM>;
 
     enum class Equality : int
     {
@@ -26,32 +40,52 @@ public:
         PERFECTLY_EQUAL = 2,
     };
 
-    Square();
-    Square(std::vector<Pos> pos);
-    Square(const Square& square) = default;
-    Square(Square&& square) noexcept = default;
+    BasicSquare();
+    BasicSquare(std::vector<Pos> pos);
+    BasicSquare(const Cells& cells);
+    BasicSquare(const BasicSquare& square) = default;
+    BasicSquare(BasicSquare&& square) noexcept = default;
 
-    ~Square() = default;
+    ~BasicSquare() = default;
 
-    Square& operator=(const Square& square) = default;
-    Square& operator=(Square&& square) noexcept = default;
+    BasicSquare& operator=(const BasicSquare& square) = default;
+    BasicSquare& operator=(BasicSquare&& square) noexcept = default;
 
-    Equality operator==(const Square& square) const;
+    Equality operator==(const BasicSquare& square) const;
 
     Pos GetPos(int num) const;
     bool SetPos(int num, const Pos& pos);
     bool SetPos(std::vector<Pos>& pos);
     bool SetPos(std::vector<Pos>&& pos);
 
+    int GetCell(int num) const;
+    const Cells& GetCells() const;
+    Mask GetMask() const;
+
+    // Ranks number every cell mask of NUM squares from 0 to NUM_RANK - 1, so
+    // that a dense array can be indexed by Square regardless of order.
+    int GetRank() const;
+    static int GetRank(Mask mask);
+
+    // Square on the NUM cells of a mask, in ascending order of cell, as a
+    // mask does not tell squares apart
+    static BasicSquare FromMask(Mask mask);
+
     int IsPosSquare(const Pos& pos) const;
     bool IsSolved() const;
 
 private:
 
-    // Use vector instead of array as the former is movable
-    std::vector<Pos> _squares;
+    // Squares are stored as packed Board cells rather than a vector of Pos
+    // so that a Square is trivially copyable and never touches the heap.
+    // Unset squares sit off the board at Pos(-1, -n), which survives the
+    // conversion to and from a cell.
+    Cells _cells{ };
 
     bool IsPosRepeated(const std::vector<Pos>& s) const;
+    bool IsCellRepeated(const Cells& cells) const;
 };
 
+using Square = BasicSquare<8, 8>;
+
 #endif // SQUARE_HPP
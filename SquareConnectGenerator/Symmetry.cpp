@@ -0,0 +1,223 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "Symmetry.hpp"
+
+#include "Solver.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <bit>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace Symmetry
+{
+
+static_assert(Board::NUM_ROW == Board::NUM_COL, "Symmetries require a square Board");
+
+static constexpr int N = Board::NUM_ROW;
+
+[[nodiscard]] static constexpr std::array<int, 2> ApplyRowCol(int t, int row, int col)
+{
+    switch (t) {
+    case 0: return { row, col };
+    case 1: return { col, N - 1 - row };
+    case 2: return { N - 1 - row, N - 1 - col };
+    case 3: return { N - 1 - col, row };
+    case 4: return { row, N - 1 - col };
+    case 5: return { N - 1 - row, col };
+    case 6: return { col, row };
+    default: return { N - 1 - col, N - 1 - row };
+    }
+}
+
+// Cell each cell is taken to.  Indexed by [Transform][cell].
+static constexpr auto CELL = []() {
+
+    std::array<std::array<int8_t, Board::NUM_TILES>, NUM_TRANSFORM> cell{ };
+
+    for (int t = 0; t < NUM_TRANSFORM; t++) {
+        for (int c = 0; c < Board::NUM_TILES; c++) {
+            auto [row, col] = ApplyRowCol(t, c / N, c % N);
+            cell[t][c] = static_cast<int8_t>(row * N + col);
+        }
+    }
+
+    return cell;
+}();
+
+// Direction each Movement::Dir is taken to, found from the step it makes.
+// Indexed by [Transform][Dir].
+static constexpr auto DIR = []() {
+
+    constexpr std::array<int, Movement::NUM_DIR + 1> rowStep{ 0, -1, 1, 0, 0 };
+    constexpr std::array<int, Movement::NUM_DIR + 1> colStep{ 0, 0, 0, -1, 1 };
+
+    std::array<std::array<Movement::Dir, Movement::NUM_DIR + 1>, NUM_TRANSFORM> dir{ };
+
+    for (int t = 0; t < NUM_TRANSFORM; t++) {
+
+        auto [row, col] = ApplyRowCol(t, 1, 1);
+
+        for (int d = 0; d <= Movement::NUM_DIR; d++) {
+
+            auto [stepRow, stepCol] = ApplyRowCol(t, 1 + rowStep[d], 1 + colStep[d]);
+
+            for (int e = 0; e <= Movement::NUM_DIR; e++) {
+                if (stepRow - row == rowStep[e] && stepCol - col == colStep[e])
+                    dir[t][d] = static_cast<Movement::Dir>(e);
+            }
+        }
+    }
+
+    return dir;
+}();
+
+Key::Key(uint64_t walls, uint64_t squares) :
+    _walls(walls),
+    _squares(squares)
+{
+}
+
+bool Key::operator==(const Key& key) const
+{
+    return _walls == key._walls && _squares == key._squares;
+}
+
+bool Key::operator<(const Key& key) const
+{
+    if (_walls != key._walls)
+        return _walls < key._walls;
+    return _squares < key._squares;
+}
+
+uint64_t Key::GetWalls() const
+{
+    return _walls;
+}
+
+uint64_t Key::GetSquares() const
+{
+    return _squares;
+}
+
+size_t KeyHash::operator()(const Key& key) const
+{
+    uint64_t hash = (key.GetWalls() ^ std::rotl(key.GetSquares(), 32)) * 0x9E3779B97F4A7C15;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+[[nodiscard]] Transform GetInverse(Transform transform)
+{
+    if (transform == Transform::ROTATE_90)
+        return Transform::ROTATE_270;
+    if (transform == Transform::ROTATE_270)
+        return Transform::ROTATE_90;
+
+    return transform;
+}
+
+[[nodiscard]] int Apply(Transform transform, int cell)
+{
+    // Precondition check
+    assert(cell >= 0 && cell < Board::NUM_TILES);
+
+    return CELL[static_cast<int>(transform)][cell];
+}
+
+[[nodiscard]] uint64_t ApplyMask(Transform transform, uint64_t mask)
+{
+    const auto& cell = CELL[static_cast<int>(transform)];
+    uint64_t retMask = 0;
+
+    for (; mask; mask &= mask - 1)
+        retMask |= static_cast<uint64_t>(1) << cell[std::countr_zero(mask)];
+
+    return retMask;
+}
+
+[[nodiscard]] Movement::Dir Apply(Transform transform, Movement::Dir dir)
+{
+    return DIR[static_cast<int>(transform)][static_cast<int>(dir)];
+}
+
+[[nodiscard]] Board Apply(Transform transform, const Board& board)
+{
+    uint64_t walls = ApplyMask(transform, board.GetWallMask());
+    std::vector<Board::Tile> tiles(Board::NUM_TILES, Board::Tile::EMPTY);
+
+    for (; walls; walls &= walls - 1)
+        tiles.at(std::countr_zero(walls)) = Board::Tile::WALL;
+
+    return Board(std::move(tiles));
+}
+
+[[nodiscard]] Square Apply(Transform transform, const Square& square)
+{
+    Square::Cells cells = square.GetCells();
+
+    for (int num = 0; num < Square::NUM; num++)
+        cells[num] = static_cast<int8_t>(Apply(transform, cells[num]));
+
+    return Square(cells);
+}
+
+[[nodiscard]] Solver::Solution Apply(Transform transform, const Solver::Solution& solution)
+{
+    if (solution.GetStatus() != Solver::Solution::Status::SOLVED)
+        return solution;
+
+    std::vector<Movement::Dir> retDir;
+    retDir.reserve(solution.GetDir().size());
+
+    for (Movement::Dir dir : solution.GetDir())
+        retDir.emplace_back(Apply(transform, dir));
+
+    std::vector<Square> retSquare;
+    retSquare.reserve(solution.GetSquare().size());
+
+    for (const Square& square : solution.GetSquare())
+        retSquare.emplace_back(Apply(transform, square));
+
+    return Solver::Solution(solution.GetStatus(), std::move(retDir), std::move(retSquare),
+                            solution.GetDepth());
+}
+
+[[nodiscard]] Transform GetCanonicalTransform(const Board& board, const Square& square)
+{
+    uint64_t walls = board.GetWallMask();
+    uint64_t squares = square.GetMask();
+
+    Transform retTrans = Transform::IDENTITY;
+    Key minKey(walls, squares);
+
+    for (int t = 1; t < NUM_TRANSFORM; t++) {
+
+        Transform trans = static_cast<Transform>(t);
+        Key key(ApplyMask(trans, walls), ApplyMask(trans, squares));
+
+        if (key < minKey) {
+            minKey = key;
+            retTrans = trans;
+        }
+    }
+
+    return retTrans;
+}
+
+[[nodiscard]] Key GetCanonicalKey(const Board& board, const Square& square)
+{
+    Transform trans = GetCanonicalTransform(board, square);
+
+    return Key(ApplyMask(trans, board.GetWallMask()), ApplyMask(trans, square.GetMask()));
+}
+
+} // namespace Symmetry
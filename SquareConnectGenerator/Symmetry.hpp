@@ -0,0 +1,87 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef SYMMETRY_HPP
+#define SYMMETRY_HPP
+
+#include "Solver.hpp"
+#include "Movement.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Symmetry
+{
+
+// The 8 symmetries of a square Board.  Rotations are clockwise.
+enum class Transform : int
+{
+    IDENTITY = 0,
+    ROTATE_90,
+    ROTATE_180,
+    ROTATE_270,
+    FLIP_HORIZONTAL,
+    FLIP_VERTICAL,
+    TRANSPOSE,
+    ANTI_TRANSPOSE,
+};
+
+static const int NUM_TRANSFORM = 8;
+
+// A puzzle up to symmetry.  Squares are not told apart, as they only differ
+// in the letter they are given.
+class Key
+{
+public:
+
+    Key() = default;
+    Key(uint64_t walls, uint64_t squares);
+    Key(const Key& key) = default;
+    Key(Key&& key) noexcept = default;
+
+    ~Key() = default;
+
+    Key& operator=(const Key& key) = default;
+    Key& operator=(Key&& key) noexcept = default;
+
+    bool operator==(const Key& key) const;
+    bool operator<(const Key& key) const;
+
+    uint64_t GetWalls() const;
+    uint64_t GetSquares() const;
+
+private:
+
+    uint64_t _walls{ 0 };
+    uint64_t _squares{ 0 };
+};
+
+struct KeyHash
+{
+    size_t operator()(const Key& key) const;
+};
+
+[[nodiscard]] Transform GetInverse(Transform transform);
+
+[[nodiscard]] int Apply(Transform transform, int cell);
+[[nodiscard]] uint64_t ApplyMask(Transform transform, uint64_t mask);
+[[nodiscard]] Movement::Dir Apply(Transform transform, Movement::Dir dir);
+[[nodiscard]] Board Apply(Transform transform, const Board& board);
+[[nodiscard]] Square Apply(Transform transform, const Square& square);
+// A unique Solution of a puzzle is transformed into the unique Solution of
+// the transformed puzzle.
+[[nodiscard]] Solver::Solution Apply(Transform transform, const Solver::Solution& solution);
+
+// Transform which takes the puzzle to its canonical orientation, which is the
+// one with the smallest Key.  Ties go to the first Transform.
+[[nodiscard]] Transform GetCanonicalTransform(const Board& board, const Square& square);
+[[nodiscard]] Key GetCanonicalKey(const Board& board, const Square& square);
+
+} // namespace Symmetry
+
+#endif // SYMMETRY_HPP
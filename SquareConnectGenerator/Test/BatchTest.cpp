@@ -0,0 +1,120 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Batch.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+static const int NUM_BATCH = 60;
+static const int MAX_BATCH_SIZE = 40;
+static const int MAX_WALL = 40;
+static const int MAX_DEPTH = 12;
+
+// Memory limit small enough for the larger puzzles to reach it
+static const size_t SMALL_MEMORY_LIMIT = 16 * 1024;
+
+// Batch::Solve must find the same Solution as the Breadth First Search for
+// each puzzle of a batch, whether the puzzles have Boards of their own or
+// share one, and with the lanes of a Workspace kept from batch to batch.
+// Under a memory limit each puzzle must either reach the limit or still find
+// the same Solution.
+int main()
+{
+    Random random(1);
+    Solver::Batch::Workspace workspace;
+    std::map<Solver::Solution::Status, int> numStatus;
+
+    for (int batNum = 0; batNum < NUM_BATCH; batNum++) {
+
+        int batchSize = random.GetInt(1, MAX_BATCH_SIZE);
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+        std::string batWhat = "Batch " + std::to_string(batNum);
+
+        // Puzzles of Boards of their own
+
+        std::vector<Board> board(batchSize);
+        std::vector<Square> square(batchSize);
+
+        for (int num = 0; num < batchSize; num++)
+            TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), board.at(num), square.at(num));
+
+        std::vector<Solver::Solution> solution = Solver::Batch::Solve(board, square, maxDepth);
+        std::vector<Solver::Solution> limited = Solver::Batch::Solve(board, square, maxDepth,
+                                                                     SMALL_MEMORY_LIMIT);
+
+        bool isSized = static_cast<int>(solution.size()) == batchSize &&
+                       static_cast<int>(limited.size()) == batchSize;
+
+        TestPuzzle::Check(isSized, "Solutions of " + batWhat);
+        if (!isSized)
+            continue;
+
+        for (int num = 0; num < batchSize; num++) {
+
+            std::string what = batWhat + " puzzle " + std::to_string(num);
+            Solver::Solution expected = Solver::SolveBreadthFirst(board.at(num),
+                                                                  square.at(num), maxDepth);
+
+            numStatus[expected.GetStatus()]++;
+            TestPuzzle::Check(TestPuzzle::IsSame(solution.at(num), expected, what),
+                              "Batch::Solve of " + what);
+
+            if (limited.at(num).GetStatus() == Solver::Solution::Status::MEMORY_LIMIT_REACHED)
+                numStatus[limited.at(num).GetStatus()]++;
+            else
+                TestPuzzle::Check(TestPuzzle::IsSame(limited.at(num), expected,
+                                                     what + " under the memory limit"),
+                                  "Batch::Solve of " + what + " under the memory limit");
+        }
+
+        // Puzzles which share the Board of the first
+
+        std::vector<Square> shared;
+        shared.reserve(batchSize);
+
+        for (int num = 0; num < batchSize; num++) {
+            Square sqr;
+            if (TestPuzzle::MakeSquare(random, board.front(), sqr))
+                shared.emplace_back(sqr);
+        }
+
+        solution = Solver::Batch::Solve(board.front(), shared, maxDepth, workspace);
+
+        isSized = solution.size() == shared.size();
+
+        TestPuzzle::Check(isSized, "Solutions of shared " + batWhat);
+        if (!isSized)
+            continue;
+
+        for (size_t num = 0; num < shared.size(); num++) {
+
+            std::string what = "Shared " + batWhat + " puzzle " + std::to_string(num);
+            Solver::Solution expected = Solver::SolveBreadthFirst(board.front(),
+                                                                  shared.at(num), maxDepth);
+
+            numStatus[expected.GetStatus()]++;
+            TestPuzzle::Check(TestPuzzle::IsSame(solution.at(num), expected, what),
+                              "Batch::Solve of " + what);
+        }
+    }
+
+    TestPuzzle::CheckStatus(numStatus, { Solver::Solution::Status::SOLVED,
+                                         Solver::Solution::Status::UNSOLVABLE,
+                                         Solver::Solution::Status::MAX_DEPTH_REACHED,
+                                         Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED,
+                                         Solver::Solution::Status::MEMORY_LIMIT_REACHED });
+
+    return TestPuzzle::GetResult();
+}
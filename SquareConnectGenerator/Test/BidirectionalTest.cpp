@@ -0,0 +1,53 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Bidirectional.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <map>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+
+static const int NUM_PUZZLE = 2000;
+static const int MAX_WALL = 40;
+static const int MAX_DEPTH = 12;
+
+// Bidirectional::Solve must find the same Solution as the Breadth First
+// Search, for every status it can end with
+int main()
+{
+    Random random(1);
+    std::map<Solver::Solution::Status, int> numStatus;
+
+    for (int num = 0; num < NUM_PUZZLE; num++) {
+
+        Board board;
+        Square square;
+        TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), board, square);
+
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+
+        Solver::Solution expected = Solver::SolveBreadthFirst(board, square, maxDepth);
+        Solver::Solution solution = Solver::Bidirectional::Solve(board, square, maxDepth);
+
+        numStatus[expected.GetStatus()]++;
+        TestPuzzle::Check(TestPuzzle::IsSame(solution, expected, "Puzzle " + std::to_string(num)),
+                          "Bidirectional::Solve of puzzle " + std::to_string(num));
+    }
+
+    TestPuzzle::CheckStatus(numStatus, { Solver::Solution::Status::SOLVED,
+                                         Solver::Solution::Status::UNSOLVABLE,
+                                         Solver::Solution::Status::MAX_DEPTH_REACHED,
+                                         Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED });
+
+    return TestPuzzle::GetResult();
+}
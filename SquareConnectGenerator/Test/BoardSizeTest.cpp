@@ -0,0 +1,249 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Movement.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+#include "Pos.hpp"
+
+#include <map>
+#include <array>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+
+static const int NUM_PUZZLE = 150;
+static const int MAX_DEPTH = 12;
+// Most walls of a Board, as a percentage of its tiles
+static const int MAX_WALL_PERCENT = 40;
+
+// Cells of a Square, in order, which identify it without its labels as the
+// Breadth First Search does
+template <int ROW, int COL>
+[[nodiscard]] static std::array<int8_t, BasicSquare<ROW, COL>::NUM> getKey(
+    const BasicSquare<ROW, COL>& square)
+{
+    std::array<int8_t, BasicSquare<ROW, COL>::NUM> retKey = square.GetCells();
+    std::sort(retKey.begin(), retKey.end());
+    return retKey;
+}
+
+// Random Board with walls on up to MAX_WALL_PERCENT of its tiles, and a random
+// Square on it which is not solved
+template <int ROW, int COL>
+static void make(Random& random, BasicBoard<ROW, COL>& board, BasicSquare<ROW, COL>& square)
+{
+    using BoardType = BasicBoard<ROW, COL>;
+    using SquareType = BasicSquare<ROW, COL>;
+
+    while (true) {
+
+        board = BoardType();
+
+        int numWall = random.GetInt(0, BoardType::NUM_TILES * MAX_WALL_PERCENT / 100);
+        for (int num = 0; num < numWall; num++)
+            board.SetTile(BoardType::GetPos(random.GetInt(0, BoardType::NUM_TILES - 1)),
+                          BoardType::Tile::WALL);
+
+        std::vector<int> open;
+        for (int cell = 0; cell < BoardType::NUM_TILES; cell++) {
+            if (board.GetTile(BoardType::GetPos(cell)) != BoardType::Tile::WALL)
+                open.emplace_back(cell);
+        }
+
+        if (static_cast<int>(open.size()) <= SquareType::NUM)
+            continue;
+
+        for (int tries = 0; tries < 10; tries++) {
+
+            std::vector<Pos> pos;
+
+            for (int num = 0; num < SquareType::NUM; num++) {
+                int idx = random.GetInt(num, static_cast<int>(open.size()) - 1);
+                std::swap(open.at(num), open.at(idx));
+                pos.emplace_back(BoardType::GetPos(open.at(num)));
+            }
+
+            square = SquareType(std::move(pos));
+
+            if (!square.IsSolved())
+                return;
+        }
+    }
+}
+
+// Checks that MoveAll finds the Square of a Move in every direction
+template <int ROW, int COL>
+static void checkMoveAll(const BasicBoard<ROW, COL>& board, const BasicSquare<ROW, COL>& square,
+                         const std::string& what)
+{
+    Movement::BasicResultAll<ROW, COL> all = Movement::MoveAll(board, square);
+
+    for (int d = 1; d <= Movement::NUM_DIR; d++) {
+
+        Movement::Dir dir = static_cast<Movement::Dir>(d);
+        Movement::BasicResult<ROW, COL> one = Movement::Move(board, square, dir);
+
+        bool isSame = all.IsSuccess(dir) == one.IsSuccess() &&
+                      ((all.GetSuccessMask() >> (d - 1)) & 1) == one.IsSuccess() &&
+                      (!one.IsSuccess() ||
+                       all.GetSquare(dir).GetCells() == one.GetSquare().GetCells());
+
+        TestPuzzle::Check(isSame, "MoveAll " + std::to_string(d) + " of " + what);
+    }
+}
+
+// Status and depth of the shortest solution, found layer by layer with single
+// Moves.  As in the Breadth First Search, Squares are told apart by their
+// cells alone, only paths from the layer before count towards a Square, and
+// two shortest paths make the solution repeated.  The Squares it expands are
+// checked with checkMoveAll along the way.
+template <int ROW, int COL>
+[[nodiscard]] static typename Solver::BasicSolution<ROW, COL>::Status solve(
+    const BasicBoard<ROW, COL>& board, const BasicSquare<ROW, COL>& square, int maxDepth,
+    int& depth, const std::string& what)
+{
+    using SquareType = BasicSquare<ROW, COL>;
+    using Status = typename Solver::BasicSolution<ROW, COL>::Status;
+    using Key = std::array<int8_t, SquareType::NUM>;
+
+    struct Entry
+    {
+        SquareType square;
+        int numPath;
+    };
+
+    std::map<Key, int> seen{ { getKey(square), 0 } };
+    std::map<Key, Entry> layer{ { getKey(square), { square, 1 } } };
+
+    for (depth = 1; depth <= maxDepth; depth++) {
+
+        std::map<Key, Entry> next;
+        int numSolvedPath = 0;
+
+        for (const auto& [key, entry] : layer) {
+
+            checkMoveAll(board, entry.square, what);
+
+            for (int d = 1; d <= Movement::NUM_DIR; d++) {
+
+                Movement::BasicResult<ROW, COL> res =
+                    Movement::Move(board, entry.square, static_cast<Movement::Dir>(d));
+
+                if (!res.IsSuccess())
+                    continue;
+
+                Key newKey = getKey(res.GetSquare());
+                auto iter = seen.find(newKey);
+
+                if (iter != seen.end() && iter->second < depth)
+                    continue;
+
+                seen.emplace(newKey, depth);
+                auto [nextIter, isNew] = next.try_emplace(newKey, Entry{ res.GetSquare(), 0 });
+                nextIter->second.numPath += entry.numPath;
+
+                if (res.GetSquare().IsSolved())
+                    numSolvedPath += entry.numPath;
+            }
+        }
+
+        if (numSolvedPath >= Solver::MAX_NUM_PATH)
+            return Status::SHORTEST_SOLUTION_REPEATED;
+
+        if (numSolvedPath > 0)
+            return Status::SOLVED;
+
+        if (next.empty())
+            return Status::UNSOLVABLE;
+
+        layer = std::move(next);
+    }
+
+    return Status::MAX_DEPTH_REACHED;
+}
+
+// Checks Movement and Solver::SolveBreadthFirst on random puzzles of one size.
+// A solved puzzle must be solved at the same depth, and its moves must take
+// the Square through the Squares of the Solution to a solved one.
+template <int ROW, int COL>
+static void checkSize(Random& random)
+{
+    using SquareType = BasicSquare<ROW, COL>;
+    using SolutionType = Solver::BasicSolution<ROW, COL>;
+    using Status = typename SolutionType::Status;
+
+    std::string sizeWhat = std::to_string(ROW) + "x" + std::to_string(COL);
+    std::map<Solver::Solution::Status, int> numStatus;
+
+    for (int num = 0; num < NUM_PUZZLE; num++) {
+
+        std::string what = sizeWhat + " puzzle " + std::to_string(num);
+
+        BasicBoard<ROW, COL> board;
+        SquareType square;
+        make(random, board, square);
+
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+        int depth = 0;
+        Status expected = solve(board, square, maxDepth, depth, what);
+        SolutionType solution = Solver::SolveBreadthFirst(board, square, maxDepth);
+
+        numStatus[static_cast<Solver::Solution::Status>(expected)]++;
+
+        TestPuzzle::Check(solution.GetStatus() == expected, "Status of " + what);
+        if (solution.GetStatus() != Status::SOLVED || expected != Status::SOLVED)
+            continue;
+
+        const std::vector<Movement::Dir>& dir = solution.GetDir();
+        const std::vector<SquareType>& sqr = solution.GetSquare();
+
+        bool isSized = solution.GetDepth() == depth &&
+                       static_cast<int>(dir.size()) == depth + 1 &&
+                       static_cast<int>(sqr.size()) == depth + 1;
+
+        TestPuzzle::Check(isSized, "Depth of " + what);
+        if (!isSized)
+            continue;
+
+        SquareType at = square;
+        bool isFollowed = dir.front() == Movement::Dir::NONE &&
+                          sqr.front().GetCells() == at.GetCells();
+
+        for (int step = 1; step <= depth && isFollowed; step++) {
+            Movement::BasicResult<ROW, COL> res = Movement::Move(board, at, dir.at(step));
+            isFollowed = res.IsSuccess() && res.GetSquare().GetCells() == sqr.at(step).GetCells();
+            at = res.GetSquare();
+        }
+
+        TestPuzzle::Check(isFollowed && at.IsSolved(), "Moves of " + what);
+    }
+
+    TestPuzzle::CheckStatus(numStatus, { Solver::Solution::Status::SOLVED,
+                                         Solver::Solution::Status::UNSOLVABLE,
+                                         Solver::Solution::Status::MAX_DEPTH_REACHED,
+                                         Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED });
+}
+
+// The templates must hold for a Board smaller than 8x8, a rectangular one and
+// one of more than 64 tiles, whose masks take two words, as well as for the
+// 8x8 Board.  BoardSize.hpp instantiates each of them for this test.
+int main()
+{
+    Random random(1);
+
+    checkSize<6, 6>(random);
+    checkSize<7, 9>(random);
+    checkSize<8, 8>(random);
+    checkSize<10, 10>(random);
+
+    return TestPuzzle::GetResult();
+}
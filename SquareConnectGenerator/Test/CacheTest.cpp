@@ -0,0 +1,62 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Symmetry.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <string>
+#include <iostream>
+#include <cstdlib>
+
+static const int NUM_PUZZLE = 500;
+static const int MAX_WALL = 40;
+static const int MAX_DEPTH = 12;
+
+// Each puzzle is solved in every orientation, all but the first of which are
+// found in the cache, and each Solution must be the one the Breadth First
+// Search finds for that orientation
+int main()
+{
+    Random random(1);
+
+    for (int num = 0; num < NUM_PUZZLE; num++) {
+
+        Board board;
+        Square square;
+        TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), board, square);
+
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+        Solver::CacheStatistics before = Solver::GetCacheStatistics();
+
+        for (int t = 0; t < Symmetry::NUM_TRANSFORM; t++) {
+
+            auto trans = static_cast<Symmetry::Transform>(t);
+            Board brd = Symmetry::Apply(trans, board);
+            Square sqr = Symmetry::Apply(trans, square);
+
+            std::string what = "Puzzle " + std::to_string(num) + " in orientation " +
+                               std::to_string(t);
+
+            Solver::Solution expected = Solver::SolveBreadthFirst(brd, sqr, maxDepth);
+            Solver::Solution solution = Solver::Solve(brd, sqr, maxDepth);
+
+            TestPuzzle::Check(TestPuzzle::IsSame(solution, expected, what),
+                              "Solver::Solve of " + what);
+        }
+
+        Solver::CacheStatistics after = Solver::GetCacheStatistics();
+
+        TestPuzzle::Check(after.GetHit() - before.GetHit() == Symmetry::NUM_TRANSFORM - 1,
+                          "Cache hits of puzzle " + std::to_string(num));
+    }
+
+    return TestPuzzle::GetResult();
+}
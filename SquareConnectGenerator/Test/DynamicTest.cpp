@@ -0,0 +1,84 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Dynamic.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+#include "Pos.hpp"
+
+#include <map>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <cstddef>
+
+static const int NUM_PUZZLE = 200;
+static const int MAX_WALL = 40;
+static const int MAX_DEPTH = 12;
+
+// Memory limit small enough for the larger puzzles to reach it
+static const size_t SMALL_MEMORY_LIMIT = 16 * 1024;
+
+// A Dynamic search is kept while walls are added to the Board one at a time,
+// as a wall scan does, and must find the same Solution as the Breadth First
+// Search after each wall.  Each Board is also solved under a small memory
+// limit first, which must either be reached or give the same Solution, and
+// must leave the search as it would be without it.
+int main()
+{
+    Random random(1);
+    Solver::Dynamic dyn;
+    std::map<Solver::Solution::Status, int> numStatus;
+
+    for (int num = 0; num < NUM_PUZZLE; num++) {
+
+        Board empty;
+        Square square;
+        TestPuzzle::Make(random, 0, empty, square);
+
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+        Board board;
+        dyn.Reset(square);
+
+        for (int numWall = 0; numWall <= MAX_WALL; numWall++) {
+
+            Pos p = Board::GetPos(random.GetInt(0, Board::NUM_TILES - 1));
+            if (square.IsPosSquare(p) < 0)
+                board.SetTile(p, Board::Tile::WALL);
+
+            std::string what = "Puzzle " + std::to_string(num) + " with " +
+                               std::to_string(numWall) + " walls";
+
+            Solver::Solution expected = Solver::SolveBreadthFirst(board, square, maxDepth);
+            Solver::Solution solution = dyn.Solve(board, maxDepth, SMALL_MEMORY_LIMIT);
+
+            if (solution.GetStatus() == Solver::Solution::Status::MEMORY_LIMIT_REACHED)
+                numStatus[solution.GetStatus()]++;
+            else
+                TestPuzzle::Check(TestPuzzle::IsSame(solution, expected,
+                                                     what + " under the memory limit"),
+                                  "Dynamic::Solve of " + what + " under the memory limit");
+
+            solution = dyn.Solve(board, maxDepth);
+
+            numStatus[expected.GetStatus()]++;
+            TestPuzzle::Check(TestPuzzle::IsSame(solution, expected, what),
+                              "Dynamic::Solve of " + what);
+        }
+    }
+
+    TestPuzzle::CheckStatus(numStatus, { Solver::Solution::Status::SOLVED,
+                                         Solver::Solution::Status::UNSOLVABLE,
+                                         Solver::Solution::Status::MAX_DEPTH_REACHED,
+                                         Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED,
+                                         Solver::Solution::Status::MEMORY_LIMIT_REACHED });
+
+    return TestPuzzle::GetResult();
+}
@@ -0,0 +1,126 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Generator.hpp"
+#include "WallSchedule.hpp"
+#include "Filter.hpp"
+#include "Profiler.hpp"
+#include "Context.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+static const uint64_t SEED = 7;
+static const int NUM_ATTEMPT = 24;
+static const int NUM_THREAD = 4;
+static const int MIN_DEPTH = 3;
+static const int MAX_DEPTH = 6;
+
+// Products of every attempt of a run, made as Main makes them.  Attempts are
+// numbered across the Generator Threads and each draws from its own stream of
+// the seed, and each Generate is worked on by numPuzzleThread threads.
+[[nodiscard]] static std::vector<Generator::Product> generate(const Filter& filter,
+                                                              Generator::Mode mode,
+                                                              int numThread,
+                                                              int numPuzzleThread,
+                                                              Generator::WallSchedule* schedule)
+{
+    std::vector<Generator::Product> retProd(NUM_ATTEMPT);
+    std::atomic<int> attempt{ 0 };
+
+    auto run = [&]() {
+
+        Solver::Context context;
+
+        for (int num = attempt.fetch_add(1); num < NUM_ATTEMPT; num = attempt.fetch_add(1)) {
+            Random random(Random::GetStreamSeed(SEED, num));
+            retProd.at(num) = Generator::Generate(filter, context, random, mode,
+                                                  numPuzzleThread, schedule);
+        }
+    };
+
+    std::vector<std::thread> thread;
+    for (int num = 1; num < numThread; num++)
+        thread.emplace_back(run);
+
+    run();
+
+    for (std::thread& t : thread)
+        t.join();
+
+    return retProd;
+}
+
+[[nodiscard]] static bool isSame(const Generator::Product& product,
+                                 const Generator::Product& expected)
+{
+    return product.GetStatus() == expected.GetStatus() &&
+           product.GetFilterNum() == expected.GetFilterNum() &&
+           product.GetBoard().GetWallMask() == expected.GetBoard().GetWallMask() &&
+           product.GetSquare().GetCells() == expected.GetSquare().GetCells() &&
+           product.GetSolution() == expected.GetSolution() &&
+           product.GetSolution().GetDir() == expected.GetSolution().GetDir();
+}
+
+// Without a WallSchedule or a KeySet, a run of every mode must make the same
+// Product of each attempt when it is made again from the same seed, and when
+// it is made by several Generator Threads which each work on a Product with
+// several threads.  The latter also adds to a WallSchedule which is not drawn
+// from, which must learn without changing any Product.
+int main()
+{
+    // Every solution of an entry's depth matches it
+    Profiler::MatchProfile mat;
+    mat.AddEntry(Profiler::Mode::SKIP_0_OR_N, { });
+
+    Filter filter;
+    for (int depth = MIN_DEPTH; depth <= MAX_DEPTH; depth++)
+        filter.AddEntry("Depth " + std::to_string(depth), depth, &mat);
+
+    for (auto mode : { Generator::Mode::WALL_SCAN,
+                       Generator::Mode::RETROGRADE,
+                       Generator::Mode::WALL_PROBE,
+                       Generator::Mode::REVERSE_WALK }) {
+
+        std::string modeWhat = "Mode " + std::to_string(static_cast<int>(mode));
+
+        std::vector<Generator::Product> expected = generate(filter, mode, 1, 1, nullptr);
+        std::vector<Generator::Product> again = generate(filter, mode, 1, 1, nullptr);
+        Generator::WallSchedule schedule(filter, false);
+        std::vector<Generator::Product> threaded = generate(filter, mode, NUM_THREAD,
+                                                            NUM_THREAD, &schedule);
+
+        int numSuccess = 0;
+
+        for (int num = 0; num < NUM_ATTEMPT; num++) {
+
+            std::string what = modeWhat + " attempt " + std::to_string(num);
+
+            numSuccess += expected.at(num).GetStatus() == Generator::Product::Status::SUCCESS;
+            TestPuzzle::Check(isSame(again.at(num), expected.at(num)), what + " made again");
+            TestPuzzle::Check(isSame(threaded.at(num), expected.at(num)),
+                              what + " made on " + std::to_string(NUM_THREAD) + " threads");
+        }
+
+        TestPuzzle::Check(numSuccess > 0, modeWhat + " makes a puzzle");
+
+        long long numTrial = 0;
+        for (int wallCnt = 0; wallCnt <= Board::NUM_TILES; wallCnt++)
+            numTrial += schedule.GetTrial(wallCnt);
+
+        TestPuzzle::Check(numTrial > 0, modeWhat + " adds to a WallSchedule not drawn from");
+    }
+
+    return TestPuzzle::GetResult();
+}
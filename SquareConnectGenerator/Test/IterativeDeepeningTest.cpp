@@ -0,0 +1,77 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "IterativeDeepening.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <map>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+
+static const int NUM_PUZZLE = 2000;
+static const int MAX_WALL = 40;
+static const int MAX_DEPTH = 12;
+// Depth a puzzle IterativeDeepening::Solve finds UNSOLVABLE is searched to
+static const int UNSOLVABLE_DEPTH = 24;
+
+[[nodiscard]] static bool IsUnsolved(Solver::Solution::Status status)
+{
+    return status == Solver::Solution::Status::UNSOLVABLE ||
+           status == Solver::Solution::Status::MAX_DEPTH_REACHED;
+}
+
+// IterativeDeepening::Solve must find the same Solution as the Breadth First
+// Search whenever there is a solution within the maximum depth.  Without one,
+// it tells an unsolvable puzzle by its lower bound rather than by running out
+// of Squares, so it may report UNSOLVABLE where the Breadth First Search
+// reports MAX_DEPTH_REACHED and the other way around.  A puzzle it reports
+// UNSOLVABLE must then have no solution far beyond the maximum depth.
+int main()
+{
+    Random random(1);
+    std::map<Solver::Solution::Status, int> numStatus;
+
+    for (int num = 0; num < NUM_PUZZLE; num++) {
+
+        Board board;
+        Square square;
+        TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), board, square);
+
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+
+        Solver::Solution expected = Solver::SolveBreadthFirst(board, square, maxDepth);
+        Solver::Solution solution = Solver::IterativeDeepening::Solve(board, square, maxDepth);
+
+        numStatus[expected.GetStatus()]++;
+        std::string what = "IterativeDeepening::Solve of puzzle " + std::to_string(num);
+
+        if (!IsUnsolved(expected.GetStatus())) {
+            TestPuzzle::Check(TestPuzzle::IsSame(solution, expected,
+                                                 "Puzzle " + std::to_string(num)), what);
+            continue;
+        }
+
+        TestPuzzle::Check(IsUnsolved(solution.GetStatus()), what + " has no solution");
+
+        if (solution.GetStatus() == Solver::Solution::Status::UNSOLVABLE) {
+            Solver::Solution deep = Solver::SolveBreadthFirst(board, square, UNSOLVABLE_DEPTH);
+            TestPuzzle::Check(IsUnsolved(deep.GetStatus()), what + " is unsolvable");
+        }
+    }
+
+    TestPuzzle::CheckStatus(numStatus, { Solver::Solution::Status::SOLVED,
+                                         Solver::Solution::Status::UNSOLVABLE,
+                                         Solver::Solution::Status::MAX_DEPTH_REACHED,
+                                         Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED });
+
+    return TestPuzzle::GetResult();
+}
@@ -0,0 +1,184 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "KeySet.hpp"
+#include "Output.hpp"
+#include "Symmetry.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <exception>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+static const int NUM_KEY = 200;
+static const int NUM_PUZZLE = 12;
+static const int MAX_WALL = 30;
+static const int MAX_DEPTH = 10;
+
+// Files of both runs of checkImport are named after one of these entries
+static const std::vector<std::string> FILE_NAME = { "Depth 3", "Depth 5" };
+
+struct Puzzle
+{
+    Board board;
+    Square square;
+    Solver::Solution solution;
+};
+
+// Random puzzle with a unique shortest solution
+[[nodiscard]] static Puzzle makePuzzle(Random& random)
+{
+    while (true) {
+
+        Puzzle puzzle;
+        TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), puzzle.board, puzzle.square);
+        puzzle.solution = Solver::SolveBreadthFirst(puzzle.board, puzzle.square, MAX_DEPTH);
+
+        if (puzzle.solution.GetStatus() == Solver::Solution::Status::SOLVED)
+            return puzzle;
+    }
+}
+
+// A KeySet loaded from the file of another must hold the same Keys, and a
+// file which is not a key set file must be rejected
+static void checkSaveLoad(Random& random, const std::filesystem::path& dir)
+{
+    std::string path = (dir / "KeySet.txt").string();
+
+    Generator::KeySet saved;
+    std::set<Symmetry::Key> key;
+
+    for (int num = 0; num < NUM_KEY; num++) {
+
+        Board board;
+        Square square;
+        TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), board, square);
+
+        Symmetry::Key k = Symmetry::GetCanonicalKey(board, square);
+        TestPuzzle::Check(saved.Claim(k) == key.insert(k).second, "Claim of a Key");
+    }
+
+    saved.Save(path);
+
+    Generator::KeySet loaded;
+    TestPuzzle::Check(loaded.Load(path), "Load of a saved key set");
+    TestPuzzle::Check(loaded.GetSize() == key.size(), "Keys loaded");
+
+    bool isLoaded = true;
+    for (const Symmetry::Key& k : key)
+        isLoaded = isLoaded && !loaded.Claim(k);
+
+    TestPuzzle::Check(isLoaded, "Keys loaded are claimed");
+    TestPuzzle::Check(loaded.GetSize() == key.size(), "Keys loaded are only claimed once");
+    TestPuzzle::Check(!loaded.Load((dir / "Missing.txt").string()), "Load of a missing file");
+
+    std::string corruptPath = (dir / "Corrupt.txt").string();
+    std::ofstream(corruptPath) << "KEY_SET 1\nKEY not_hex\n";
+
+    bool isRejected = false;
+    try {
+        Generator::KeySet corrupt;
+        corrupt.Load(corruptPath);
+    } catch (const std::exception&) {
+        isRejected = true;
+    }
+
+    TestPuzzle::Check(isRejected, "Load of a corrupt file");
+}
+
+// Import must read the canonical Key of every puzzle which Output wrote over
+// two runs, of which the second wrote a mirror image of a puzzle of the
+// first, and count the puzzles of each file name.  A file which is not a
+// puzzle file adds nothing.
+static void checkImport(Random& random, const std::filesystem::path& dir)
+{
+    std::filesystem::path outputDir = dir / "output";
+    std::set<Symmetry::Key> key;
+    std::map<std::string, int> expectedCount;
+    int numWritten = 0;
+
+    {
+        Output first((outputDir / "first").string());
+        Output second((outputDir / "second").string());
+
+        for (int num = 0; num < NUM_PUZZLE; num++) {
+
+            Puzzle puzzle = makePuzzle(random);
+            Output& output = num % 2 == 0 ? first : second;
+            const std::string& fileName = FILE_NAME.at(num % FILE_NAME.size());
+            std::string subDir = "Depth_" + std::to_string(puzzle.solution.GetDepth());
+
+            if (!output.AppendToFile(subDir, fileName, num, puzzle.board, puzzle.square,
+                                     puzzle.solution))
+                continue;
+
+            key.insert(Symmetry::GetCanonicalKey(puzzle.board, puzzle.square));
+            expectedCount[fileName]++;
+            numWritten++;
+
+            // The second run writes the mirror image of the first puzzle,
+            // which the first has already written
+            if (num != 0)
+                continue;
+
+            auto flip = Symmetry::Transform::FLIP_HORIZONTAL;
+            Board board = Symmetry::Apply(flip, puzzle.board);
+            Square square = Symmetry::Apply(flip, puzzle.square);
+            Solver::Solution solution = Symmetry::Apply(flip, puzzle.solution);
+
+            TestPuzzle::Check(second.AppendToFile(subDir, fileName, num, board, square, solution),
+                              "Mirror image written by another run");
+
+            expectedCount[fileName]++;
+            numWritten++;
+        }
+    }
+
+    std::ofstream(outputDir / "first" / "Notes.txt") << "Not a puzzle file\n";
+
+    Generator::KeySet keySet;
+    int numFail = -1;
+    std::map<std::string, int> fileCount;
+    size_t numPuzzle = keySet.Import(outputDir.string(), numFail, fileCount);
+
+    TestPuzzle::Check(numFail == 0, "Files which failed to import");
+    TestPuzzle::Check(numPuzzle == static_cast<size_t>(numWritten), "Puzzles imported");
+    TestPuzzle::Check(fileCount == expectedCount, "Puzzles imported of each file name");
+    TestPuzzle::Check(keySet.GetSize() == key.size(), "Keys imported");
+
+    bool isImported = true;
+    for (const Symmetry::Key& k : key)
+        isImported = isImported && !keySet.Claim(k);
+
+    TestPuzzle::Check(isImported, "Keys imported are canonical");
+    TestPuzzle::Check(keySet.GetSize() == key.size(), "Keys imported are only claimed once");
+}
+
+int main()
+{
+    Random random(1);
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "KeySetTest";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    checkSaveLoad(random, dir);
+    checkImport(random, dir);
+
+    std::filesystem::remove_all(dir);
+
+    return TestPuzzle::GetResult();
+}
@@ -0,0 +1,82 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Parallel.hpp"
+#include "WorkerPool.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <map>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <cstddef>
+
+static const int NUM_PUZZLE = 1000;
+static const int MAX_WALL = 40;
+static const int MAX_DEPTH = 12;
+static const int NUM_THREAD = 4;
+// Layers of this many nodes are split across the threads, which is every
+// layer.  The layers of these puzzles rarely reach a hundred nodes, far
+// fewer than Parallel::DEFAULT_MIN_PARALLEL_NODE.
+static const int MIN_PARALLEL_NODE = 1;
+
+// Memory limit small enough for the larger puzzles to reach it
+static const size_t SMALL_MEMORY_LIMIT = 48 * 1024;
+
+// Parallel::Solve must find the same Solution as the Breadth First Search,
+// which includes telling a shortest solution found over MAX_NUM_PATH paths
+// as repeated.  Under a memory limit it must either reach the limit or still
+// find the same Solution.
+int main()
+{
+    Random random(1);
+    Solver::WorkerPool pool;
+    std::map<Solver::Solution::Status, int> numStatus;
+
+    for (int num = 0; num < NUM_PUZZLE; num++) {
+
+        Board board;
+        Square square;
+        TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), board, square);
+
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+        std::string what = "Puzzle " + std::to_string(num);
+
+        Solver::Solution expected = Solver::SolveBreadthFirst(board, square, maxDepth);
+        Solver::Solution solution = Solver::Parallel::Solve(board, square, maxDepth, pool,
+                                                            NUM_THREAD,
+                                                            Solver::DEFAULT_MEMORY_LIMIT,
+                                                            MIN_PARALLEL_NODE);
+
+        numStatus[expected.GetStatus()]++;
+        TestPuzzle::Check(TestPuzzle::IsSame(solution, expected, what),
+                          "Parallel::Solve of puzzle " + std::to_string(num));
+
+        solution = Solver::Parallel::Solve(board, square, maxDepth, pool, NUM_THREAD,
+                                           SMALL_MEMORY_LIMIT, MIN_PARALLEL_NODE);
+
+        if (solution.GetStatus() == Solver::Solution::Status::MEMORY_LIMIT_REACHED)
+            numStatus[solution.GetStatus()]++;
+        else
+            TestPuzzle::Check(TestPuzzle::IsSame(solution, expected,
+                                                 what + " under the memory limit"),
+                              "Parallel::Solve of puzzle " + std::to_string(num) +
+                              " under the memory limit");
+    }
+
+    TestPuzzle::CheckStatus(numStatus, { Solver::Solution::Status::SOLVED,
+                                         Solver::Solution::Status::UNSOLVABLE,
+                                         Solver::Solution::Status::MAX_DEPTH_REACHED,
+                                         Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED,
+                                         Solver::Solution::Status::MEMORY_LIMIT_REACHED });
+
+    return TestPuzzle::GetResult();
+}
@@ -0,0 +1,152 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "ProductQueue.hpp"
+#include "Generator.hpp"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+
+static const int NUM_PRODUCER = 4;
+static const int NUM_ITEM = 5000;
+static const int SMALL_CAPACITY = 8;
+
+// Longest a Pop waits for a Product which must be on its way
+static constexpr std::chrono::milliseconds POP_TIMEOUT{ 5000 };
+// Time a blocked Push is given to return if it wrongly does
+static constexpr std::chrono::milliseconds BLOCK_WAIT{ 300 };
+
+// Products carry the producer and the number of the item in their Filter
+// number, which is all the queue is checked with
+[[nodiscard]] static Generator::Product makeProduct(int producer, int item)
+{
+    return Generator::Product(Generator::Product::Status::SUCCESS, producer * NUM_ITEM + item);
+}
+
+// Every Product pushed by several producers through a small queue must be
+// popped, and the Products of each producer in the order it pushed them
+static void checkOrder()
+{
+    Generator::ProductQueue queue(SMALL_CAPACITY);
+    std::atomic<int> numFailedPush{ 0 };
+
+    std::vector<std::thread> thread;
+    for (int producer = 0; producer < NUM_PRODUCER; producer++) {
+        thread.emplace_back([&queue, &numFailedPush, producer]() {
+            for (int item = 0; item < NUM_ITEM; item++) {
+                if (!queue.Push(makeProduct(producer, item)))
+                    numFailedPush++;
+            }
+        });
+    }
+
+    std::vector<int> nextItem(NUM_PRODUCER, 0);
+    bool isOrdered = true;
+    int numPopped = 0;
+
+    for (; numPopped < NUM_PRODUCER * NUM_ITEM; numPopped++) {
+
+        Generator::Product prod;
+        if (!queue.Pop(prod, POP_TIMEOUT))
+            break;
+
+        int producer = prod.GetFilterNum() / NUM_ITEM;
+        int item = prod.GetFilterNum() % NUM_ITEM;
+
+        isOrdered = isOrdered && producer >= 0 && producer < NUM_PRODUCER &&
+                    item == nextItem.at(producer);
+        if (producer >= 0 && producer < NUM_PRODUCER)
+            nextItem.at(producer) = item + 1;
+    }
+
+    for (std::thread& t : thread)
+        t.join();
+
+    Generator::Product extra;
+
+    TestPuzzle::Check(numFailedPush.load() == 0, "Push to an open queue");
+    TestPuzzle::Check(numPopped == NUM_PRODUCER * NUM_ITEM, "Products popped");
+    TestPuzzle::Check(isOrdered, "Order of the Products of each producer");
+    TestPuzzle::Check(!queue.Pop(extra, std::chrono::milliseconds(0)), "Pop of an empty queue");
+}
+
+// A Push to a full queue must wait until a Product is popped, and the
+// Products must come out in the order they went in
+static void checkBackpressure()
+{
+    Generator::ProductQueue queue(SMALL_CAPACITY);
+
+    for (int item = 0; item < SMALL_CAPACITY; item++)
+        TestPuzzle::Check(queue.Push(makeProduct(0, item)), "Push to a queue with room");
+
+    std::atomic<bool> isPushed{ false };
+    bool isSuccess = false;
+
+    std::thread producer([&]() {
+        isSuccess = queue.Push(makeProduct(0, SMALL_CAPACITY));
+        isPushed.store(true);
+    });
+
+    std::this_thread::sleep_for(BLOCK_WAIT);
+    TestPuzzle::Check(!isPushed.load(), "Push to a full queue waits");
+
+    bool isOrdered = true;
+
+    for (int item = 0; item <= SMALL_CAPACITY; item++) {
+        Generator::Product prod;
+        isOrdered = isOrdered && queue.Pop(prod, POP_TIMEOUT) && prod.GetFilterNum() == item;
+    }
+
+    producer.join();
+
+    TestPuzzle::Check(isSuccess, "Push to a full queue once a Product is popped");
+    TestPuzzle::Check(isOrdered, "Order of the Products of a full queue");
+}
+
+// Close must release a Push waiting on a full queue, which fails and leaves
+// its Product as it is, and fail every Push after it.  Products pushed before
+// are still popped.
+static void checkClose()
+{
+    Generator::ProductQueue queue(1);
+
+    TestPuzzle::Check(queue.Push(makeProduct(0, 0)), "Push to a queue with room");
+
+    bool isSuccess = true;
+    Generator::Product blocked = makeProduct(0, 1);
+
+    std::thread producer([&]() {
+        isSuccess = queue.Push(std::move(blocked));
+    });
+
+    std::this_thread::sleep_for(BLOCK_WAIT);
+    queue.Close();
+    producer.join();
+
+    Generator::Product prod;
+
+    TestPuzzle::Check(!isSuccess, "Push released by Close");
+    TestPuzzle::Check(blocked.GetFilterNum() == 1, "Product of a Push released by Close");
+    TestPuzzle::Check(queue.Pop(prod, POP_TIMEOUT) && prod.GetFilterNum() == 0,
+                      "Pop of a Product pushed before Close");
+    TestPuzzle::Check(!queue.Push(makeProduct(0, 2)), "Push to a closed queue with room");
+    TestPuzzle::Check(!queue.Pop(prod, std::chrono::milliseconds(0)),
+                      "Pop of a closed empty queue");
+}
+
+int main()
+{
+    checkOrder();
+    checkBackpressure();
+    checkClose();
+
+    return TestPuzzle::GetResult();
+}
@@ -0,0 +1,82 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Random.hpp"
+
+#include <limits>
+#include <string>
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+
+static const int NUM_DRAW = 1000;
+
+// Draws of a range must stay within it and reach both of its ends
+static void checkRange(Random& random, int min, int max, const std::string& what)
+{
+    bool isMinSeen = false;
+    bool isMaxSeen = false;
+    bool isInRange = true;
+    bool isNegativeSeen = false;
+    bool isPositiveSeen = false;
+
+    for (int num = 0; num < NUM_DRAW; num++) {
+
+        int value = random.GetInt(min, max);
+
+        isInRange = isInRange && value >= min && value <= max;
+        isMinSeen = isMinSeen || value == min;
+        isMaxSeen = isMaxSeen || value == max;
+        isNegativeSeen = isNegativeSeen || value < 0;
+        isPositiveSeen = isPositiveSeen || value > 0;
+    }
+
+    TestPuzzle::Check(isInRange, what + " stays in range");
+
+    // Ends of a wide range are too rare to be drawn, so the draws only have to
+    // fall on either side of zero
+    if (static_cast<int64_t>(max) - min < NUM_DRAW / 10) {
+        TestPuzzle::Check(isMinSeen, what + " draws the minimum");
+        TestPuzzle::Check(isMaxSeen, what + " draws the maximum");
+    } else {
+        TestPuzzle::Check(isNegativeSeen && isPositiveSeen, what + " draws either side of zero");
+    }
+}
+
+int main()
+{
+    static const int INT_MIN_VALUE = std::numeric_limits<int>::min();
+    static const int INT_MAX_VALUE = std::numeric_limits<int>::max();
+
+    Random random(1);
+
+    checkRange(random, INT_MIN_VALUE, INT_MAX_VALUE, "GetInt of every int");
+    checkRange(random, INT_MIN_VALUE + 1, INT_MAX_VALUE, "GetInt of every int but the minimum");
+    checkRange(random, INT_MIN_VALUE, INT_MAX_VALUE - 1, "GetInt of every int but the maximum");
+    checkRange(random, INT_MIN_VALUE, INT_MIN_VALUE + 1, "GetInt of the lowest ints");
+    checkRange(random, INT_MAX_VALUE - 1, INT_MAX_VALUE, "GetInt of the highest ints");
+    checkRange(random, -3, 3, "GetInt of a small range");
+
+    TestPuzzle::Check(random.GetInt(INT_MIN_VALUE, INT_MIN_VALUE) == INT_MIN_VALUE,
+                      "GetInt of the minimum");
+    TestPuzzle::Check(random.GetInt(INT_MAX_VALUE, INT_MAX_VALUE) == INT_MAX_VALUE,
+                      "GetInt of the maximum");
+
+    // The sequence only depends on the seed
+    Random first(Random::GetStreamSeed(7, 3));
+    Random second(Random::GetStreamSeed(7, 3));
+    bool isSame = true;
+
+    for (int num = 0; num < NUM_DRAW; num++)
+        isSame = isSame && first.GetInt(INT_MIN_VALUE, INT_MAX_VALUE) ==
+                           second.GetInt(INT_MIN_VALUE, INT_MAX_VALUE);
+
+    TestPuzzle::Check(isSame, "GetInt of the same seed repeats");
+
+    return TestPuzzle::GetResult();
+}
@@ -0,0 +1,98 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "Retrograde.hpp"
+#include "WorkerPool.hpp"
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+static const int NUM_BOARD = 40;
+static const int NUM_SQUARE = 25;
+// Squares of each depth checked from the unique masks of a Board
+static const int NUM_UNIQUE = 4;
+static const int MAX_WALL = 40;
+static const int MAX_DEPTH = 12;
+static const int NUM_THREAD = 4;
+
+// The Table of a Board must give each Square the depth and uniqueness of the
+// Solution the Breadth First Search finds for it, and the unique masks of a
+// depth must be Squares which the Breadth First Search solves at that depth.
+// One Table is built again for every Board, on a random number of threads.
+int main()
+{
+    Random random(1);
+    Solver::WorkerPool pool;
+    Retrograde::Table table;
+    std::map<Solver::Solution::Status, int> numStatus;
+
+    for (int brdNum = 0; brdNum < NUM_BOARD; brdNum++) {
+
+        Board board;
+        Square square;
+        TestPuzzle::Make(random, random.GetInt(0, MAX_WALL), board, square);
+
+        int maxDepth = random.GetInt(1, MAX_DEPTH);
+        table.Build(board, maxDepth, random.GetInt(1, NUM_THREAD), &pool);
+
+        std::string brdWhat = "Board " + std::to_string(brdNum);
+
+        for (int sqrNum = 0; sqrNum < NUM_SQUARE; sqrNum++) {
+
+            if (sqrNum > 0 && !TestPuzzle::MakeSquare(random, board, square))
+                break;
+
+            std::string what = brdWhat + " with Square " + std::to_string(sqrNum);
+
+            Solver::Solution expected = Solver::SolveBreadthFirst(board, square, maxDepth);
+            Solver::Solution::Status status = expected.GetStatus();
+            int depth = table.GetDepth(square);
+
+            numStatus[status]++;
+
+            if (status == Solver::Solution::Status::SOLVED) {
+                TestPuzzle::Check(depth == expected.GetDepth(), "Depth of " + what);
+                TestPuzzle::Check(table.IsUnique(square), "Uniqueness of " + what);
+            } else if (status == Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED) {
+                TestPuzzle::Check(depth > 0 && depth <= maxDepth, "Depth of " + what);
+                TestPuzzle::Check(!table.IsUnique(square), "Uniqueness of " + what);
+            } else {
+                TestPuzzle::Check(depth == Retrograde::Table::UNSOLVABLE, "Depth of " + what);
+            }
+        }
+
+        for (int depth = 1; depth <= maxDepth; depth++) {
+
+            const std::vector<uint64_t>& mask = table.GetUniqueMask(depth);
+
+            for (int num = 0; num < NUM_UNIQUE && !mask.empty(); num++) {
+
+                int idx = random.GetInt(0, static_cast<int>(mask.size()) - 1);
+                Square sqr = Square::FromMask(mask.at(idx));
+                Solver::Solution expected = Solver::SolveBreadthFirst(board, sqr, maxDepth);
+
+                TestPuzzle::Check(expected.GetStatus() == Solver::Solution::Status::SOLVED &&
+                                  expected.GetDepth() == depth,
+                                  brdWhat + " unique mask of depth " + std::to_string(depth));
+            }
+        }
+    }
+
+    TestPuzzle::CheckStatus(numStatus, { Solver::Solution::Status::SOLVED,
+                                         Solver::Solution::Status::UNSOLVABLE,
+                                         Solver::Solution::Status::MAX_DEPTH_REACHED,
+                                         Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED });
+
+    return TestPuzzle::GetResult();
+}
@@ -0,0 +1,153 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef TEST_PUZZLE_HPP
+#define TEST_PUZZLE_HPP
+
+#include "Solver.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+#include "Square.hpp"
+#include "Pos.hpp"
+
+#include <map>
+#include <initializer_list>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+
+namespace TestPuzzle
+{
+
+// Checks which failed so far
+inline int _numFail{ 0 };
+
+// Counts a failed check and writes out what failed
+inline void Check(bool isPassed, const std::string& what)
+{
+    if (isPassed)
+        return;
+
+    std::cerr << "Failed: " << what << std::endl;
+    _numFail++;
+}
+
+// Exit code of the test, which passed if no check failed
+[[nodiscard]] inline int GetResult()
+{
+    if (_numFail > 0)
+        return EXIT_FAILURE;
+
+    std::cout << "Passed" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+// Random Square on the Board which is not solved, or false if there is not
+// room for one.  Only a Board with a few tiles left open may have none.
+inline bool MakeSquare(Random& random, const Board& board, Square& square)
+{
+    int numOpen = 0;
+    for (int num = 0; num < Board::NUM_TILES; num++)
+        numOpen += board.GetTile(Board::GetPos(num)) != Board::Tile::WALL;
+
+    if (numOpen <= Square::NUM)
+        return false;
+
+    while (true) {
+
+        std::vector<Pos> pos;
+
+        while (static_cast<int>(pos.size()) < Square::NUM) {
+
+            Pos p = Board::GetPos(random.GetInt(0, Board::NUM_TILES - 1));
+            bool isTaken = board.GetTile(p) == Board::Tile::WALL;
+
+            for (const Pos& q : pos)
+                isTaken = isTaken || q == p;
+
+            if (!isTaken)
+                pos.emplace_back(p);
+        }
+
+        square = Square(std::move(pos));
+
+        if (!square.IsSolved())
+            return true;
+    }
+}
+
+// Random Board of numWall walls, and a random Square which is not solved
+inline void Make(Random& random, int numWall, Board& board, Square& square)
+{
+    while (true) {
+
+        board = Board();
+
+        for (int num = 0; num < numWall; num++)
+            board.SetTile(Board::GetPos(random.GetInt(0, Board::NUM_TILES - 1)),
+                          Board::Tile::WALL);
+
+        if (MakeSquare(random, board, square))
+            return;
+    }
+}
+
+// Name of a Solution status, for the messages of a failed check
+[[nodiscard]] inline std::string GetStatusName(Solver::Solution::Status status)
+{
+    switch (status) {
+    case Solver::Solution::Status::NONE: return "NONE";
+    case Solver::Solution::Status::SOLVED: return "SOLVED";
+    case Solver::Solution::Status::UNSOLVABLE: return "UNSOLVABLE";
+    case Solver::Solution::Status::MAX_DEPTH_REACHED: return "MAX_DEPTH_REACHED";
+    case Solver::Solution::Status::SHORTEST_SOLUTION_REPEATED: return "SHORTEST_SOLUTION_REPEATED";
+    default: return "MEMORY_LIMIT_REACHED";
+    }
+}
+
+// Whether a Solution is the one Solver::SolveBreadthFirst found, which
+// compares the status, and so whether the shortest solution is unique, and
+// the depth, moves and Squares of a solved puzzle.  The differences are
+// written out under the name of the puzzle.
+[[nodiscard]] inline bool IsSame(const Solver::Solution& solution,
+                                 const Solver::Solution& expected, const std::string& what)
+{
+    std::string diff;
+
+    if (solution.GetStatus() != expected.GetStatus())
+        diff = "status " + GetStatusName(solution.GetStatus()) + " instead of " +
+               GetStatusName(expected.GetStatus());
+    else if (solution.GetDepth() != expected.GetDepth())
+        diff = "depth " + std::to_string(solution.GetDepth()) + " instead of " +
+               std::to_string(expected.GetDepth());
+    else if (solution.GetDir() != expected.GetDir())
+        diff = "other moves";
+    else if (!(solution == expected))
+        diff = "other Squares";
+
+    if (diff.empty())
+        return true;
+
+    std::cerr << what << ": " << diff << std::endl;
+    return false;
+}
+
+// Checks that some puzzle ended with each of the statuses, so that the
+// comparisons covered every way a search can end
+inline void CheckStatus(const std::map<Solver::Solution::Status, int>& numStatus,
+                        std::initializer_list<Solver::Solution::Status> status)
+{
+    for (auto s : status) {
+        auto iter = numStatus.find(s);
+        Check(iter != numStatus.end() && iter->second > 0,
+              "Puzzles which end with " + GetStatusName(s));
+    }
+}
+
+} // namespace TestPuzzle
+
+#endif // TEST_PUZZLE_HPP
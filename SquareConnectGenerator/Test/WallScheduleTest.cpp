@@ -0,0 +1,189 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "TestPuzzle.hpp"
+
+#include "WallSchedule.hpp"
+#include "Filter.hpp"
+#include "Profiler.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <exception>
+#include <vector>
+#include <string>
+#include <utility>
+
+static const int NUM_ADD = 5000;
+
+// Titles of the entries of the Filter the statistics are saved with, and of
+// the one they are loaded into, which shares the first and the last
+static const std::vector<std::string> SAVED_TITLE = { "Depth 3", "Depth 5", "Depth 7" };
+static const std::vector<std::string> LOADED_TITLE = { "Depth 7", "Depth 9", "Depth 3" };
+
+// Adds an entry of each title, whose depth is the number in the title
+static void addEntries(Filter& filter, const std::vector<std::string>& title,
+                       const Profiler::MatchProfile& mat)
+{
+    for (const std::string& t : title)
+        filter.AddEntry(t, std::stoi(t.substr(t.find(' ') + 1)), &mat);
+}
+
+// Whether two schedules hold the same statistics, the entries of the second
+// being those of the first with the given titles
+[[nodiscard]] static bool isSame(const Generator::WallSchedule& schedule,
+                                 const std::vector<std::string>& title,
+                                 const Generator::WallSchedule& expected,
+                                 const std::vector<std::string>& expectedTitle)
+{
+    for (int wallCnt = 0; wallCnt <= Board::NUM_TILES; wallCnt++) {
+
+        if (schedule.GetTrial(wallCnt) != expected.GetTrial(wallCnt))
+            return false;
+
+        for (size_t num = 0; num < title.size(); num++) {
+
+            long long numMatch = 0;
+            for (size_t exp = 0; exp < expectedTitle.size(); exp++) {
+                if (expectedTitle.at(exp) == title.at(num))
+                    numMatch = expected.GetMatch(wallCnt, static_cast<int>(exp));
+            }
+
+            if (schedule.GetMatch(wallCnt, static_cast<int>(num)) != numMatch)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+[[nodiscard]] static std::string readFile(const std::string& path)
+{
+    std::ifstream ifs(path);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+// Statistics saved and loaded again must be the same, with the entries
+// matched by title, and loading them again must add them once more
+static void checkSaveLoad(const std::filesystem::path& dir, const Profiler::MatchProfile& mat)
+{
+    std::string path = (dir / "WallSchedule.txt").string();
+
+    Filter savedFilter;
+    Filter loadedFilter;
+    addEntries(savedFilter, SAVED_TITLE, mat);
+    addEntries(loadedFilter, LOADED_TITLE, mat);
+
+    Random random(1);
+
+    Generator::WallSchedule saved(savedFilter);
+    for (int num = 0; num < NUM_ADD; num++)
+        saved.Add(random.GetInt(0, Board::NUM_TILES),
+                  random.GetInt(-1, static_cast<int>(SAVED_TITLE.size()) - 1));
+
+    saved.Save(path);
+
+    TestPuzzle::Check(!std::filesystem::exists(path + ".tmp"), "Temporary file of Save");
+
+    Generator::WallSchedule same(savedFilter);
+    TestPuzzle::Check(same.Load(path), "Load of a saved file");
+    TestPuzzle::Check(isSame(same, SAVED_TITLE, saved, SAVED_TITLE), "Statistics loaded");
+
+    Generator::WallSchedule other(loadedFilter);
+    TestPuzzle::Check(other.Load(path), "Load of a saved file into another Filter");
+    TestPuzzle::Check(isSame(other, LOADED_TITLE, saved, SAVED_TITLE),
+                      "Statistics loaded into another Filter");
+
+    Generator::WallSchedule twice(savedFilter);
+    TestPuzzle::Check(twice.Load(path) && twice.Load(path), "Load of a saved file twice");
+
+    bool isAdded = true;
+    for (int wallCnt = 0; wallCnt <= Board::NUM_TILES; wallCnt++)
+        isAdded = isAdded && twice.GetTrial(wallCnt) == 2 * saved.GetTrial(wallCnt);
+
+    TestPuzzle::Check(isAdded, "Statistics loaded twice");
+
+    std::string againPath = (dir / "WallScheduleAgain.txt").string();
+    same.Save(againPath);
+
+    TestPuzzle::Check(readFile(againPath) == readFile(path),
+                      "File saved of the loaded statistics");
+
+    Generator::WallSchedule missing(savedFilter);
+    TestPuzzle::Check(!missing.Load((dir / "Missing.txt").string()), "Load of a missing file");
+}
+
+// A file which is not one must be rejected, and must leave the statistics as
+// they were, even where its first counts could be read
+static void checkCorrupt(const std::filesystem::path& dir, const Profiler::MatchProfile& mat)
+{
+    std::string path = (dir / "WallSchedule.txt").string();
+    std::string corruptPath = (dir / "Corrupt.txt").string();
+    std::string header = "WALL_SCHEDULE " + std::to_string(Board::NUM_TILES + 1) + "\n";
+
+    std::string valid = readFile(path);
+    std::vector<std::pair<std::string, std::string>> corrupt = {
+        { "Empty file", "" },
+        { "Other header", "KEY_SET 1\n" },
+        { "Other number of wall counts", "WALL_SCHEDULE 10\n" },
+        { "Unknown tag", valid + "TOTAL 5\n" },
+        { "Wall count out of range", valid + "COUNT " + std::to_string(Board::NUM_TILES + 1) +
+                                     " 1 0 0 0\n" },
+        { "Negative trials", valid + "COUNT 3 -1 0 0 0\n" },
+        { "Negative matches", valid + "COUNT 3 1 -1 0 0\n" },
+        { "More matches than trials", valid + "COUNT 3 1 2 0 0\n" },
+        { "Missing matches", valid + "COUNT 3 4 1\n" },
+        { "Matches which are not numbers", header + "ENTRY Depth 3\nCOUNT 3 4 x\n" },
+    };
+
+    Filter filter;
+    addEntries(filter, SAVED_TITLE, mat);
+
+    Generator::WallSchedule expected(filter);
+    expected.Load(path);
+
+    for (const auto& [what, text] : corrupt) {
+
+        std::ofstream(corruptPath, std::ios_base::trunc) << text;
+
+        Generator::WallSchedule schedule(filter);
+        schedule.Load(path);
+
+        bool isRejected = false;
+        try {
+            schedule.Load(corruptPath);
+        } catch (const std::exception&) {
+            isRejected = true;
+        }
+
+        TestPuzzle::Check(isRejected, "Load of a corrupt file: " + what);
+        TestPuzzle::Check(isSame(schedule, SAVED_TITLE, expected, SAVED_TITLE),
+                          "Statistics after a corrupt file: " + what);
+    }
+}
+
+int main()
+{
+    // Every solution of an entry's depth matches it
+    Profiler::MatchProfile mat;
+    mat.AddEntry(Profiler::Mode::SKIP_0_OR_N, { });
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "WallScheduleTest";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    checkSaveLoad(dir, mat);
+    checkCorrupt(dir, mat);
+
+    std::filesystem::remove_all(dir);
+
+    return TestPuzzle::GetResult();
+}
@@ -10,86 +10,91 @@
 #include "Board.hpp"
 #include "Square.hpp"
 #include "Pos.hpp"
+#include "BoardSize.hpp"
 
 #include <array>
 #include <vector>
-#include <thread>
-#include <random>
 #include <stdexcept>
+#include <type_traits>
 #include <cassert>
 
 namespace Util
 {
 
-[[nodiscard]] int GetRandomInt(int min, int max)
+template <int ROW, int COL>
+[[nodiscard]] bool IsSquareWithinBoard(const BasicSquare<ROW, COL>& square)
 {
-    static thread_local std::mt19937* gen = nullptr;
-    if (!gen) {
-        gen = new std::mt19937(static_cast<unsigned int>(clock() +
-                               std::hash<std::thread::id>()(std::this_thread::get_id())));
-    }
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(*gen);
-}
-
-[[nodiscard]] bool IsSquareWithinBoard(const Square& square)
-{
-    for (int num = 0; num < Square::NUM; num++) {
+    for (int num = 0; num < BasicSquare<ROW, COL>::NUM; num++) {
 
         Pos pos = square.GetPos(num);
 
-        if (pos.GetRow() < 0 || pos.GetRow() >= Board::NUM_ROW ||
-            pos.GetCol() < 0 || pos.GetCol() >= Board::NUM_COL) {
+        if (pos.GetRow() < 0 || pos.GetRow() >= ROW ||
+            pos.GetCol() < 0 || pos.GetCol() >= COL) {
             return false;
         }
     }
     return true;
 }
 
-[[nodiscard]] bool IsBoardSquareSane(const Board& board, const Square& square)
+template <int ROW, int COL>
+[[nodiscard]] bool IsBoardSquareSane(const BasicBoard<ROW, COL>& board,
+                                     const BasicSquare<ROW, COL>& square)
 {
     if (!IsSquareWithinBoard(square))
         return false;
 
-    for (int num = 0; num < Square::NUM; num++) {
+    for (int num = 0; num < BasicSquare<ROW, COL>::NUM; num++) {
 
         Pos pos = square.GetPos(num);
 
-        if (pos.GetRow() < 0 || pos.GetRow() >= Board::NUM_ROW ||
-            pos.GetCol() < 0 || pos.GetCol() >= Board::NUM_COL) {
+        if (pos.GetRow() < 0 || pos.GetRow() >= ROW ||
+            pos.GetCol() < 0 || pos.GetCol() >= COL) {
             return false;
         }
 
-        if (board.GetTile(pos) == Board::Tile::WALL)
+        if (board.GetTile(pos) == BasicBoard<ROW, COL>::Tile::WALL)
             return false;
     }
     return true;
 }
 
-[[nodiscard]] bool IsBoardSquareSolutionSane(const Board& board, const Square& square,
-                                             const Solver::Solution& solution)
+template <int ROW, int COL>
+[[nodiscard]] bool IsBoardSquareSolutionSane(const BasicBoard<ROW, COL>& board,
+                                             const BasicSquare<ROW, COL>& square,
+                                             const Solver::BasicSolution<ROW, COL>& solution)
 {
     if (!IsBoardSquareSane(board, square))
         return false;
 
-    Solver::Solution sol = Solver::Solve(board, square, solution.GetDepth());
+    Solver::BasicSolution<ROW, COL> sol;
+
+    // The 8x8 Board goes through the Solution cache
+    if constexpr (std::is_same_v<BasicBoard<ROW, COL>, Board>)
+        sol = Solver::Solve(board, square, solution.GetDepth());
+    else
+        sol = Solver::SolveBreadthFirst(board, square, solution.GetDepth());
+
     if (!(sol == solution))
         return false;
 
     return true;
 }
 
+template <int ROW, int COL>
 void CharVectorToBoardAndSquare(const std::vector<char>& charVec,
-                                Board& board, Square& square)
+                                BasicBoard<ROW, COL>& board, BasicSquare<ROW, COL>& square)
 {
-    if (charVec.size() != Board::NUM_TILES)                     // Precondition check
+    using BoardType = BasicBoard<ROW, COL>;
+    using SquareType = BasicSquare<ROW, COL>;
+
+    if (charVec.size() != BoardType::NUM_TILES)                 // Precondition check
         throw std::invalid_argument("Invalid charVec size");
 
-    std::array<bool, Square::NUM> squareFound{ false, false, false, false };
-    Board retBoard;
-    Square retSquare;
+    std::array<bool, SquareType::NUM> squareFound{ false, false, false, false };
+    BoardType retBoard;
+    SquareType retSquare;
 
-    for (int num = 0; num < Board::NUM_TILES; num++) {
+    for (int num = 0; num < BoardType::NUM_TILES; num++) {
 
         char c = charVec.at(num);
 
@@ -97,10 +102,10 @@ void CharVectorToBoardAndSquare(const std::vector<char>& charVec,
         if (c == 'O')
             continue;
 
-        Pos pos(num / Board::NUM_ROW, num % Board::NUM_ROW);
+        Pos pos(num / BoardType::NUM_COL, num % BoardType::NUM_COL);
 
         if (c == 'X') {
-            retBoard.SetTile(pos, Board::Tile::WALL);
+            retBoard.SetTile(pos, BoardType::Tile::WALL);
         
         } else if (c >= 'A' && c <= 'D') {
             
@@ -121,39 +126,57 @@ void CharVectorToBoardAndSquare(const std::vector<char>& charVec,
     square = std::move(retSquare);
 }
 
-void BoardAndSquareToCharVector(const Board& board, const Square& square,
+template <int ROW, int COL>
+void BoardAndSquareToCharVector(const BasicBoard<ROW, COL>& board,
+                                const BasicSquare<ROW, COL>& square,
                                 std::vector<char>& charVec)
 {
+    using BoardType = BasicBoard<ROW, COL>;
+    using SquareType = BasicSquare<ROW, COL>;
+
     std::vector<char> retVec;
-    retVec.reserve(Board::NUM_TILES);
+    retVec.reserve(BoardType::NUM_TILES);
 
-    for (int row = 0; row < Board::NUM_ROW; row++) {
-        for (int col = 0; col < Board::NUM_COL; col++) {
+    for (int row = 0; row < BoardType::NUM_ROW; row++) {
+        for (int col = 0; col < BoardType::NUM_COL; col++) {
 
             Pos pos(row, col);
 
-            if (board.GetTile(pos) == Board::Tile::EMPTY)
+            if (board.GetTile(pos) == BoardType::Tile::EMPTY)
                 retVec.emplace_back('O');
-            else if (board.GetTile(pos) == Board::Tile::WALL)
+            else if (board.GetTile(pos) == BoardType::Tile::WALL)
                 retVec.emplace_back('X');
         }
     }
 
-    for (int num = 0; num < Square::NUM; num++) {
+    for (int num = 0; num < SquareType::NUM; num++) {
         Pos pos = square.GetPos(num);
 
-        if (pos.GetRow() < 0 || pos.GetRow() >= Board::NUM_ROW ||
-            pos.GetCol() < 0 || pos.GetCol() >= Board::NUM_COL)
+        if (pos.GetRow() < 0 || pos.GetRow() >= BoardType::NUM_ROW ||
+            pos.GetCol() < 0 || pos.GetCol() >= BoardType::NUM_COL)
             throw std::invalid_argument("Square pos not within board bounds");
 
-        if (board.GetTile(pos) == Board::Tile::WALL)
+        if (board.GetTile(pos) == BoardType::Tile::WALL)
             throw std::invalid_argument("Square pos coincides with board Wall");
 
-        retVec.at(static_cast<size_t>(pos.GetRow()) * Board::NUM_ROW + pos.GetCol()) =
+        retVec.at(static_cast<size_t>(pos.GetRow()) * BoardType::NUM_COL + pos.GetCol()) =
                 'A' + static_cast<char>(num);
     }
 
     charVec = std::move(retVec);
 }
 
+#define INSTANTIATE(ROW, COL) \
+    template bool IsSquareWithinBoard(const BasicSquare<ROW, COL>&); \
+    template bool IsBoardSquareSane(const BasicBoard<ROW, COL>&, const BasicSquare<ROW, COL>&); \
+    template bool IsBoardSquareSolutionSane(const BasicBoard<ROW, COL>&, \
+                                            const BasicSquare<ROW, COL>&, \
+                                            const Solver::BasicSolution<ROW, COL>&); \
+    template void CharVectorToBoardAndSquare(const std::vector<char>&, \
+                                             BasicBoard<ROW, COL>&, BasicSquare<ROW, COL>&); \
+    template void BoardAndSquareToCharVector(const BasicBoard<ROW, COL>&, \
+                                             const BasicSquare<ROW, COL>&, std::vector<char>&);
+BOARD_SIZE_LIST(INSTANTIATE)
+#undef INSTANTIATE
+
 } // namespace Util
@@ -16,12 +16,17 @@
 namespace Util
 {
 
-[[nodiscard]] int GetRandomInt(int min, int max);
-
-[[nodiscard]] bool IsSquareWithinBoard(const Square& square);
-[[nodiscard]] bool IsBoardSquareSane(const Board& board, const Square& square);
-[[nodiscard]] bool IsBoardSquareSolutionSane(const Board& board, const Square& square,
-                                             const Solver::Solution& solution);
+// The functions below are instantiated for every size in BoardSize.hpp
+
+template <int ROW, int COL>
+[[nodiscard]] bool IsSquareWithinBoard(const BasicSquare<ROW, COL>& square);
+template <int ROW, int COL>
+[[nodiscard]] bool IsBoardSquareSane(const BasicBoard<ROW, COL>& board,
+                                     const BasicSquare<ROW, COL>& square);
+template <int ROW, int COL>
+[[nodiscard]] bool IsBoardSquareSolutionSane(const BasicBoard<ROW, COL>& board,
+                                             const BasicSquare<ROW, COL>& square,
+                                             const Solver::BasicSolution<ROW, COL>& solution);
 
 // Char map is as follows:
 //     'O' => empty
@@ -30,9 +35,14 @@ namespace Util
 //     'B' => square1
 //     'C' => square2
 //     'D' => square3
+//
+// Tiles are in row major order.
+template <int ROW, int COL>
 void CharVectorToBoardAndSquare(const std::vector<char>& tiles,
-                                Board& board, Square& square);
-void BoardAndSquareToCharVector(const Board& board, const Square& square,
+                                BasicBoard<ROW, COL>& board, BasicSquare<ROW, COL>& square);
+template <int ROW, int COL>
+void BoardAndSquareToCharVector(const BasicBoard<ROW, COL>& board,
+                                const BasicSquare<ROW, COL>& square,
                                 std::vector<char>& charVec);
 
 } // namespace Util
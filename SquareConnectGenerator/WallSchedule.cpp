@@ -0,0 +1,345 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "WallSchedule.hpp"
+
+#include "Filter.hpp"
+#include "Random.hpp"
+#include "Board.hpp"
+
+#include <filesystem>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <utility>
+#include <numbers>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace Generator
+{
+
+// The file holds a header, the title of each entry in the order of the match
+// columns, and a line for each wall count which has been tried:
+//
+//     WALL_SCHEDULE <number of wall counts>
+//     ENTRY <title>
+//     COUNT <wall count> <trials> <matches of each entry>
+static const std::string FILE_HEADER = "WALL_SCHEDULE";
+static const std::string FILE_ENTRY = "ENTRY";
+static const std::string FILE_COUNT = "COUNT";
+
+// Wall counts from no walls to a Board full of them
+static const int NUM_WALL_COUNT = Board::NUM_TILES + 1;
+
+// Box-Muller transform, of which only one of the pair is used
+[[nodiscard]] static double GetNormal(Random& random)
+{
+    double u = 1.0 - random.GetReal();
+    double v = random.GetReal();
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * std::numbers::pi * v);
+}
+
+// Marsaglia and Tsang's method, which holds for shapes of at least one
+[[nodiscard]] static double GetGamma(Random& random, double shape)
+{
+    // Precondition check
+    assert(shape >= 1.0);
+
+    double d = shape - 1.0 / 3.0;
+    double c = 1.0 / std::sqrt(9.0 * d);
+
+    while (true) {
+
+        double x = GetNormal(random);
+        double v = 1.0 + c * x;
+        if (v <= 0.0)
+            continue;
+
+        v = v * v * v;
+        double u = 1.0 - random.GetReal();
+
+        if (std::log(u) < 0.5 * x * x + d - d * v + d * std::log(v))
+            return d * v;
+    }
+}
+
+[[nodiscard]] static double GetBeta(Random& random, double alpha, double beta)
+{
+    double x = GetGamma(random, alpha);
+    double y = GetGamma(random, beta);
+    return x / (x + y);
+}
+
+WallSchedule::WallSchedule(const Filter& filter, bool isDrawn) :
+    _isDrawn(isDrawn),
+    _trial(NUM_WALL_COUNT, 0),
+    _match(filter.GetNumEntry(), std::vector<long long>(NUM_WALL_COUNT, 0)),
+    _quota(filter.GetNumEntry(), 1)
+{
+    _title.reserve(filter.GetNumEntry());
+    for (int entNum = 0; entNum < filter.GetNumEntry(); entNum++)
+        _title.emplace_back(filter.GetEntryTitle(entNum));
+}
+
+[[nodiscard]] bool WallSchedule::IsDrawn() const
+{
+    return _isDrawn;
+}
+
+[[nodiscard]] int WallSchedule::Draw(Random& random, int minWall, int maxWall) const
+{
+    // Precondition check
+    assert(minWall >= 0 && minWall <= maxWall && maxWall < NUM_WALL_COUNT);
+
+    std::vector<double> rate;
+    if (!DrawRate(random, minWall, maxWall, rate))
+        return random.GetInt(minWall, maxWall);
+
+    return minWall + static_cast<int>(std::max_element(rate.begin(), rate.end()) - rate.begin());
+}
+
+void WallSchedule::DrawRange(Random& random, int minWall, int maxWall, double mass,
+                             int& minRange, int& maxRange) const
+{
+    // Precondition check
+    assert(minWall >= 0 && minWall <= maxWall && maxWall < NUM_WALL_COUNT);
+    assert(mass > 0.0 && mass <= 1.0);
+
+    minRange = minWall;
+    maxRange = maxWall;
+
+    std::vector<double> rate;
+    if (!DrawRate(random, minWall, maxWall, rate))
+        return;
+
+    double total = 0.0;
+    for (double r : rate)
+        total += r;
+
+    // The mass left out is split evenly between the two ends
+    double tail = total * (1.0 - mass) / 2.0;
+    double sum = 0.0;
+
+    for (int wallCnt = minWall; wallCnt <= maxWall; wallCnt++) {
+        sum += rate.at(wallCnt - minWall);
+        if (sum > tail) {
+            minRange = wallCnt;
+            break;
+        }
+    }
+
+    sum = 0.0;
+
+    for (int wallCnt = maxWall; wallCnt >= minWall; wallCnt--) {
+        sum += rate.at(wallCnt - minWall);
+        if (sum > tail) {
+            maxRange = wallCnt;
+            break;
+        }
+    }
+}
+
+bool WallSchedule::DrawRate(Random& random, int minWall, int maxWall,
+                            std::vector<double>& rate) const
+{
+    if (random.GetInt(0, EXPLORE_INTERVAL - 1) == 0)
+        return false;
+
+    // Matches and misses of each count for the entry, taken under the lock
+    // and drawn from after it
+    std::vector<std::pair<long long, long long>> result;
+    result.reserve(maxWall - minWall + 1);
+
+    {
+        auto lock = std::scoped_lock{ _mutex };
+
+        long long totalQuota = 0;
+        for (long long quota : _quota)
+            totalQuota += quota;
+
+        if (totalQuota == 0)
+            return false;
+
+        // Entry of each puzzle still wanted is as likely.  The total may be
+        // beyond the range of GetInt.
+        long long pick = std::min(static_cast<long long>(random.GetReal() * totalQuota),
+                                  totalQuota - 1);
+        int entNum = 0;
+
+        while (pick >= _quota.at(entNum)) {
+            pick -= _quota.at(entNum);
+            entNum++;
+        }
+
+        for (int wallCnt = minWall; wallCnt <= maxWall; wallCnt++) {
+            long long numMatch = _match.at(entNum).at(wallCnt);
+            result.emplace_back(numMatch, _trial.at(wallCnt) - numMatch);
+        }
+    }
+
+    rate.clear();
+    rate.reserve(result.size());
+
+    for (const auto& [numMatch, numMiss] : result) {
+        rate.emplace_back(GetBeta(random, static_cast<double>(numMatch + 1),
+                                  static_cast<double>(numMiss + PRIOR_TRIAL)));
+    }
+
+    return true;
+}
+
+void WallSchedule::Add(int wallCnt, int filterNum)
+{
+    // Precondition check
+    assert(wallCnt >= 0 && wallCnt < NUM_WALL_COUNT);
+    assert(filterNum < static_cast<int>(_match.size()));
+
+    auto lock = std::scoped_lock{ _mutex };
+
+    _trial.at(wallCnt)++;
+    if (filterNum >= 0)
+        _match.at(filterNum).at(wallCnt)++;
+}
+
+void WallSchedule::SetQuota(int filterNum, long long quota)
+{
+    // Precondition check
+    assert(filterNum >= 0 && filterNum < static_cast<int>(_quota.size()));
+    assert(quota >= 0);
+
+    auto lock = std::scoped_lock{ _mutex };
+    _quota.at(filterNum) = quota;
+}
+
+long long WallSchedule::GetTrial(int wallCnt) const
+{
+    auto lock = std::scoped_lock{ _mutex };
+    return _trial.at(wallCnt);
+}
+
+long long WallSchedule::GetMatch(int wallCnt, int filterNum) const
+{
+    auto lock = std::scoped_lock{ _mutex };
+    return _match.at(filterNum).at(wallCnt);
+}
+
+bool WallSchedule::Load(const std::string& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs.is_open())
+        return false;
+
+    std::string line;
+    std::string tag;
+    int numWallCnt = 0;
+
+    if (!std::getline(ifs, line) || !(std::istringstream(line) >> tag >> numWallCnt) ||
+        tag != FILE_HEADER || numWallCnt != NUM_WALL_COUNT)
+        throw std::runtime_error("Reading wall schedule header failed");
+
+    // Entry of the Filter of each match column of the file, or -1 if the
+    // Filter has no entry of that title
+    std::vector<int> column;
+
+    // The file is read in full before anything is added, so that a file
+    // which turns out not to be one leaves the statistics as they were
+    std::vector<long long> trial(NUM_WALL_COUNT, 0);
+    std::vector<std::vector<long long>> match(_title.size(),
+                                              std::vector<long long>(NUM_WALL_COUNT, 0));
+
+    while (std::getline(ifs, line)) {
+
+        std::istringstream iss(line);
+        if (!(iss >> tag))
+            continue;
+
+        if (tag == FILE_ENTRY) {
+
+            std::string title;
+            std::getline(iss >> std::ws, title);
+
+            int entNum = -1;
+            for (int num = 0; num < static_cast<int>(_title.size()); num++) {
+                if (_title.at(num) == title)
+                    entNum = num;
+            }
+
+            column.emplace_back(entNum);
+            continue;
+        }
+
+        int wallCnt = 0;
+        long long numTrial = 0;
+
+        if (tag != FILE_COUNT || !(iss >> wallCnt >> numTrial) ||
+            wallCnt < 0 || wallCnt >= NUM_WALL_COUNT || numTrial < 0)
+            throw std::runtime_error("Reading wall schedule count failed");
+
+        trial.at(wallCnt) += numTrial;
+
+        for (int entNum : column) {
+
+            long long numMatch = 0;
+            if (!(iss >> numMatch) || numMatch < 0 || numMatch > numTrial)
+                throw std::runtime_error("Reading wall schedule match failed");
+
+            if (entNum >= 0)
+                match.at(entNum).at(wallCnt) += numMatch;
+        }
+    }
+
+    auto lock = std::scoped_lock{ _mutex };
+
+    for (int wallCnt = 0; wallCnt < NUM_WALL_COUNT; wallCnt++) {
+
+        _trial.at(wallCnt) += trial.at(wallCnt);
+
+        for (size_t entNum = 0; entNum < match.size(); entNum++)
+            _match.at(entNum).at(wallCnt) += match.at(entNum).at(wallCnt);
+    }
+
+    return true;
+}
+
+void WallSchedule::Save(const std::string& path) const
+{
+    std::string tempPath = path + ".tmp";
+
+    {
+        std::ofstream ofs(tempPath, std::ios_base::trunc);
+        if (!ofs.is_open())
+            throw std::runtime_error("Opening wall schedule file failed");
+
+        ofs << FILE_HEADER << " " << NUM_WALL_COUNT << "\n";
+        for (const std::string& title : _title)
+            ofs << FILE_ENTRY << " " << title << "\n";
+
+        auto lock = std::scoped_lock{ _mutex };
+
+        for (int wallCnt = 0; wallCnt < NUM_WALL_COUNT; wallCnt++) {
+
+            if (_trial.at(wallCnt) == 0)
+                continue;
+
+            ofs << FILE_COUNT << " " << wallCnt << " " << _trial.at(wallCnt);
+            for (const std::vector<long long>& match : _match)
+                ofs << " " << match.at(wallCnt);
+            ofs << "\n";
+        }
+
+        if (!ofs.flush())
+            throw std::runtime_error("Writing wall schedule file failed");
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+} // namespace Generator
@@ -0,0 +1,109 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef WALL_SCHEDULE_HPP
+#define WALL_SCHEDULE_HPP
+
+#include "Filter.hpp"
+#include "Random.hpp"
+
+#include <mutex>
+#include <vector>
+#include <string>
+
+namespace Generator
+{
+
+// Learns how often a Board of each wall count matches each Filter entry, and
+// draws the wall count of the next Board toward the counts which match most.
+// Every Board counts as a trial of its wall count, and as a match of the entry
+// it matched, if any.
+//
+// A draw first picks an entry, each in proportion to the puzzles still wanted
+// of it, so the counts are drawn toward the entries which are furthest behind
+// rather than those which match most easily.  The count is then drawn by
+// Thompson sampling on the matches of that entry: a match rate is drawn for
+// each wall count from the Beta distribution of its matches and misses, and
+// the count with the highest rate is taken.  Counts with few trials have wide
+// distributions and so still win now and then, until their trials say
+// otherwise.  The prior of each count is one match in PRIOR_TRIAL trials,
+// which is kept optimistic as matches are rare.  One draw in EXPLORE_INTERVAL
+// ignores what has been learned and is uniform, so no count is ever starved,
+// even by statistics loaded from a run with another Filter.  Any number of
+// threads may draw and add at once.
+//
+// A schedule which is not drawn from only learns.  The Generator then draws
+// wall counts as it would without a schedule, so that what it makes does not
+// depend on the statistics, and adds each Board to the schedule all the same.
+class WallSchedule
+{
+public:
+
+    WallSchedule(const Filter& filter, bool isDrawn = true);
+    WallSchedule(const WallSchedule& schedule) = delete;
+    WallSchedule(WallSchedule&& schedule) = delete;
+
+    ~WallSchedule() = default;
+
+    WallSchedule& operator=(const WallSchedule& schedule) = delete;
+    WallSchedule& operator=(WallSchedule&& schedule) = delete;
+
+    [[nodiscard]] bool IsDrawn() const;
+
+    // Wall count from minWall to maxWall inclusive
+    [[nodiscard]] int Draw(Random& random, int minWall, int maxWall) const;
+
+    // Range of wall counts from minWall to maxWall inclusive which holds the
+    // given share of the drawn match rates, with what is left out split
+    // evenly between the two ends.  The explorations are the whole range.
+    void DrawRange(Random& random, int minWall, int maxWall, double mass,
+                   int& minRange, int& maxRange) const;
+
+    // Adds a trial of the wall count, which matched entry filterNum of the
+    // Filter, or nothing if filterNum is negative
+    void Add(int wallCnt, int filterNum);
+
+    // Puzzles still wanted of entry filterNum, which is 1 for every entry
+    // until it is set.  An entry with none left is never drawn for.
+    void SetQuota(int filterNum, long long quota);
+
+    long long GetTrial(int wallCnt) const;
+    long long GetMatch(int wallCnt, int filterNum) const;
+
+    // Adds the statistics of a file written by Save, matching the entries by
+    // their titles and dropping those the Filter does not have.  Returns
+    // false if there is no file, and throws, adding nothing, if the file is
+    // not one.
+    bool Load(const std::string& path);
+
+    // Writes the statistics to a file, by way of a temporary file so that a
+    // file is never left half written.  Throws on failure.
+    void Save(const std::string& path) const;
+
+private:
+
+    static const int PRIOR_TRIAL = 64;
+    static const int EXPLORE_INTERVAL = 8;
+
+    std::vector<std::string> _title;
+    bool _isDrawn;
+
+    mutable std::mutex _mutex;
+    // Trials of each wall count
+    std::vector<long long> _trial;
+    // Matches of each Filter entry at each wall count
+    std::vector<std::vector<long long>> _match;
+    // Puzzles still wanted of each Filter entry
+    std::vector<long long> _quota;
+
+    // Match rate of each count from minWall to maxWall, drawn for an entry
+    // picked by the quotas.  Returns false for an exploration.
+    bool DrawRate(Random& random, int minWall, int maxWall, std::vector<double>& rate) const;
+};
+
+} // namespace Generator
+
+#endif // WALL_SCHEDULE_HPP
@@ -0,0 +1,118 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#include "WorkerPool.hpp"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Solver
+{
+
+WorkerPool::~WorkerPool()
+{
+    {
+        auto lock = std::scoped_lock{ _mutex };
+        _stop = true;
+    }
+
+    _start.notify_all();
+
+    for (auto& t : _thread)
+        t.join();
+}
+
+void WorkerPool::RunCall(int numTask, int numThread, const void* task, Call call)
+{
+    // Precondition check
+    assert(numTask >= 0);
+    assert(numThread > 0);
+
+    numThread = std::min(numThread, numTask);
+
+    if (numThread <= 1) {
+        for (int num = 0; num < numTask; num++)
+            call(task, num, 0);
+        return;
+    }
+
+    // Threads are only ever added, and wait for the next Run once started
+    for (int worker = static_cast<int>(_thread.size()) + 1; worker < numThread; worker++)
+        _thread.emplace_back(&WorkerPool::Work, this, worker);
+
+    {
+        auto lock = std::scoped_lock{ _mutex };
+
+        _task = task;
+        _call = call;
+        _numTask = numTask;
+        _nextTask.store(0, std::memory_order_relaxed);
+        _numWorker = numThread;
+        _numBusy = numThread - 1;
+        _run++;
+    }
+
+    _start.notify_all();
+
+    TakeTasks(0);
+
+    auto lock = std::unique_lock{ _mutex };
+    _done.wait(lock, [this] { return _numBusy == 0; });
+}
+
+void WorkerPool::Work(int worker)
+{
+    uint64_t lastRun = 0;
+
+    while (true) {
+
+        {
+            auto lock = std::unique_lock{ _mutex };
+
+            // A worker left out of a Run waits for the next one it is in
+            _start.wait(lock, [&] {
+                return _stop || (_run != lastRun && worker < _numWorker);
+            });
+
+            if (_stop)
+                return;
+
+            lastRun = _run;
+        }
+
+        TakeTasks(worker);
+
+        bool isLast = false;
+
+        {
+            auto lock = std::scoped_lock{ _mutex };
+            isLast = (--_numBusy == 0);
+        }
+
+        if (isLast)
+            _done.notify_one();
+    }
+}
+
+void WorkerPool::TakeTasks(int worker)
+{
+    while (true) {
+
+        int num = _nextTask.fetch_add(1, std::memory_order_relaxed);
+        if (num >= _numTask)
+            break;
+
+        _call(_task, num, worker);
+    }
+}
+
+} // namespace Solver
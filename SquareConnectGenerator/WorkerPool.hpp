@@ -0,0 +1,83 @@
+/* Copyright (C) Normal Fish Studios - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited
+ * Proprietary and confidential
+ * Written by Dennis Law <normalfish.master@gmail.com>, April 2022
+ */
+
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstdint>
+
+namespace Solver
+{
+
+// Threads which help one thread with its tasks, and which are kept from one
+// Run to the next, so that a Run only wakes them rather than starting them.
+// The calling thread is worker 0, and the threads of the pool are workers 1
+// and up, which also keep whatever they hold per thread between Runs.  Only
+// the thread which owns the pool may Run it, and a task must not Run the same
+// pool.
+class WorkerPool
+{
+public:
+
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool& pool) = delete;
+    WorkerPool(WorkerPool&& pool) = delete;
+
+    ~WorkerPool();
+
+    WorkerPool& operator=(const WorkerPool& pool) = delete;
+    WorkerPool& operator=(WorkerPool&& pool) = delete;
+
+    // Run task(num, worker) for every num below numTask on up to numThread
+    // workers.  The tasks are taken in order from a shared counter by the
+    // next free worker, so a slow task does not hold up the others.  Returns
+    // once every task is done, which makes a Run a barrier between the tasks
+    // before it and those after it.
+    template <typename Task>
+    void Run(int numTask, int numThread, const Task& task);
+
+private:
+
+    using Call = void (*)(const void* task, int num, int worker);
+
+    std::vector<std::thread> _thread{ };
+
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _done;
+
+    // Number of the Run, which the workers wait on to change
+    uint64_t _run{ 0 };
+    bool _stop{ false };
+    int _numWorker{ 0 };
+    int _numBusy{ 0 };
+
+    const void* _task{ nullptr };
+    Call _call{ nullptr };
+    int _numTask{ 0 };
+    std::atomic<int> _nextTask{ 0 };
+
+    void RunCall(int numTask, int numThread, const void* task, Call call);
+    void Work(int worker);
+    void TakeTasks(int worker);
+};
+
+template <typename Task>
+void WorkerPool::Run(int numTask, int numThread, const Task& task)
+{
+    RunCall(numTask, numThread, &task, [](const void* t, int num, int worker) {
+        (*static_cast<const Task*>(t))(num, worker);
+    });
+}
+
+} // namespace Solver
+
+#endif // WORKER_POOL_HPP